@@ -24,6 +24,7 @@ print_usage()
   echo "       --nojobs     : Disables multi-processor build on unix"
   echo "       --noomp      : Disables openmp build"
   echo "       --nocmd      : Disables mm software building"
+  echo "       --bench      : Enables micro benchmarks building"
   echo "";
   echo "    Examples:";
   echo "      $0 "; 
@@ -57,6 +58,7 @@ while [[ $# -gt 0 ]] ; do
     --nojobs      ) NUMBER_OF_PROCESSORS=1;;
     --noomp       ) CMAKE_FLAGS+=( "-DUSE_OPENMP=OFF" );;
     --nocmd       ) CMAKE_FLAGS+=( "-DMM_BUILD_CMD=OFF" );;
+    --bench       ) CMAKE_FLAGS+=( "-DMM_BUILD_BENCH=ON" );;
     *             ) print_usage "unsupported arguments: $C ";;
   esac
   shift;
@@ -0,0 +1,121 @@
+// ************* COPYRIGHT AND CONFIDENTIALITY INFORMATION *********
+// Copyright 2021 - InterDigital
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+// Author: jean-eudes.marvie@interdigital.com
+// *****************************************************************
+
+// micro benchmark of the normal computations.
+// face normals and normalization are computed on a single thread, first per triangle with glm
+// and then with computeFaceNormalsBatch and normalizeBatch for each instruction set supported by the cpu.
+// the vertex normals of the model are then computed with and without seams using all the threads.
+// usage: mmBenchNormals [triangleCount]
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+//
+#include "mmGeometry.h"
+#include "mmModel.h"
+
+using namespace mm;
+
+int main( int argc, char* argv[] ) {
+  const size_t triangleCount = argc > 1 ? std::atoi( argv[1] ) : 1000000;
+  const size_t vertexCount   = triangleCount / 2 + 3;
+
+  // random positions, each triangle uses vertices close in memory as in a real mesh,
+  // one vertex out of four is duplicated as on uv seams
+  std::mt19937                          rng( 1 );
+  std::uniform_real_distribution<float> pos( 0.0f, 1.0f );
+  std::uniform_int_distribution<int>    ofs( 0, 64 );
+  Model                                 model;
+  model.vertices.resize( vertexCount * 3 );
+  for ( size_t i = 0; i < vertexCount * 3; ++i ) model.vertices[i] = pos( rng );
+  for ( size_t i = 4; i < vertexCount; i += 4 ) {
+    std::copy( &model.vertices[( i - 1 ) * 3], &model.vertices[i * 3], &model.vertices[i * 3] );
+  }
+  model.triangles.resize( triangleCount * 3 );
+  for ( size_t i = 0; i < triangleCount; ++i ) {
+    const int base = (int)std::min( i / 2, vertexCount - 65 );
+    for ( size_t j = 0; j < 3; ++j ) model.triangles[i * 3 + j] = base + ofs( rng );
+  }
+
+  // reference results, one triangle at a time
+  std::vector<float> refNormals( triangleCount * 3 );
+  auto               start = std::chrono::steady_clock::now();
+  for ( size_t i = 0; i < triangleCount; ++i ) {
+    const glm::vec3 normal = glm::cross( model.fetchPosition( i, 1 ) - model.fetchPosition( i, 0 ),
+                                         model.fetchPosition( i, 2 ) - model.fetchPosition( i, 0 ) );
+    for ( glm::vec3::length_type c = 0; c < 3; c++ ) refNormals[i * 3 + c] = normal[c];
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "triangles = " << triangleCount << std::endl;
+  std::cout << "glm::cross: " << elapsed.count() << " sec., " << triangleCount / elapsed.count() / 1e6
+            << " Mtriangles/sec" << std::endl;
+
+  std::vector<float> refNormalized( refNormals );
+  start = std::chrono::steady_clock::now();
+  for ( size_t i = 0; i < triangleCount; ++i ) {
+    glm::vec3 normal = glm::normalize( glm::make_vec3( &refNormalized[i * 3] ) );
+    if ( std::isnan( normal[0] ) ) normal = glm::vec3( 0.0F, 0.0F, 1.0F );
+    for ( glm::vec3::length_type c = 0; c < 3; c++ ) refNormalized[i * 3 + c] = normal[c];
+  }
+  elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "glm::normalize: " << elapsed.count() << " sec., " << triangleCount / elapsed.count() / 1e6
+            << " Mtriangles/sec" << std::endl;
+
+  // results must be bit exact with glm
+  const char*               names[]   = { "scalar", "sse2", "avx2" };
+  const Geometry::SimdLevel supported = Geometry::getSimdLevel();
+  int                       status    = 0;
+  std::vector<float>        normals( triangleCount * 3 );
+  for ( int level = Geometry::SIMD_SCALAR; level <= supported; ++level ) {
+    Geometry::setSimdLevel( (Geometry::SimdLevel)level );
+    start = std::chrono::steady_clock::now();
+    Geometry::computeFaceNormalsBatch( triangleCount, model.vertices.data(), model.triangles.data(), normals.data() );
+    elapsed       = std::chrono::steady_clock::now() - start;
+    bool mismatch = std::memcmp( normals.data(), refNormals.data(), normals.size() * sizeof( float ) ) != 0;
+    std::cout << "computeFaceNormalsBatch " << names[level] << ": " << elapsed.count() << " sec., "
+              << triangleCount / elapsed.count() / 1e6 << " Mtriangles/sec" << ( mismatch ? ", mismatch" : "" )
+              << std::endl;
+    if ( mismatch ) status = 1;
+
+    start = std::chrono::steady_clock::now();
+    Geometry::normalizeBatch( triangleCount, normals.data() );
+    elapsed  = std::chrono::steady_clock::now() - start;
+    mismatch = std::memcmp( normals.data(), refNormalized.data(), normals.size() * sizeof( float ) ) != 0;
+    std::cout << "normalizeBatch " << names[level] << ": " << elapsed.count() << " sec., "
+              << triangleCount / elapsed.count() / 1e6 << " Mtriangles/sec" << ( mismatch ? ", mismatch" : "" )
+              << std::endl;
+    if ( mismatch ) status = 1;
+  }
+  Geometry::setSimdLevel( supported );
+
+  // whole model, face normals included
+  for ( const bool noSeams : { false, true } ) {
+    model.normals.clear();
+    model.faceNormals.clear();
+    start   = std::chrono::steady_clock::now();
+    model.computeVertexNormals( true, noSeams );
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Model::computeVertexNormals noSeams=" << ( noSeams ? "true" : "false" ) << ": " << elapsed.count()
+              << " sec., " << triangleCount / elapsed.count() / 1e6 << " Mtriangles/sec" << std::endl;
+  }
+  return status;
+}
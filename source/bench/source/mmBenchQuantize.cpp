@@ -0,0 +1,106 @@
+// ************* COPYRIGHT AND CONFIDENTIALITY INFORMATION *********
+// Copyright 2021 - InterDigital
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+// Author: jean-eudes.marvie@interdigital.com
+// *****************************************************************
+
+// micro benchmark of the bounding box and the position quantization on a single thread.
+// computed first on the interleaved positions of the model as Quantize::quantize did, and then on
+// a Vec3Soa with the batch functions for each instruction set supported by the cpu.
+// the conversions between the two layouts are included in the timings of the batch functions.
+// usage: mmBenchQuantize [vertexCount [qp]]
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+//
+#include "mmGeometry.h"
+#include "mmModel.h"
+
+using namespace mm;
+
+int main( int argc, char* argv[] ) {
+  const size_t   vertexCount = argc > 1 ? std::atoi( argv[1] ) : 1000000;
+  const uint32_t qp          = argc > 2 ? std::atoi( argv[2] ) : 12;
+
+  // random positions, some of them exactly zero to exercise the sign of zero bounds
+  std::mt19937                          rng( 1 );
+  std::uniform_real_distribution<float> pos( -1000.0f, 1000.0f );
+  std::vector<float>                    vertices( vertexCount * 3 );
+  for ( size_t i = 0; i < vertexCount * 3; ++i ) vertices[i] = i % 1000 == 7 ? 0.0f : pos( rng );
+
+  // reference results, as Quantize::quantize on the interleaved positions
+  glm::vec3 refMin, refMax;
+  auto      start = std::chrono::steady_clock::now();
+  Geometry::computeBBox( vertices, refMin, refMax );
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "vertices = " << vertexCount << std::endl;
+  std::cout << "computeBBox interleaved: " << elapsed.count() << " sec., " << vertexCount / elapsed.count() / 1e6
+            << " Mvertices/sec" << std::endl;
+
+  const glm::vec3    diag  = refMax - refMin;
+  const float        range = std::max( std::max( diag.x, diag.y ), diag.z );
+  const double       scale = (double)range / ( ( 1u << qp ) - 1 );
+  std::vector<float> refQuantized( vertices );
+  start = std::chrono::steady_clock::now();
+  for ( size_t i = 0; i < vertexCount; i++ ) {
+    for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
+      uint32_t pos =
+        static_cast<uint32_t>( std::floor( ( ( double( refQuantized[i * 3 + c] - refMin[c] ) ) / scale ) + 0.5f ) );
+      refQuantized[i * 3 + c] = static_cast<float>( pos );
+    }
+  }
+  elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "quantize interleaved: " << elapsed.count() << " sec., " << vertexCount / elapsed.count() / 1e6
+            << " Mvertices/sec" << std::endl;
+
+  // results must be bit exact with the interleaved code
+  const char*               names[]   = { "scalar", "sse2", "avx2" };
+  const Geometry::SimdLevel supported = Geometry::getSimdLevel();
+  int                       status    = 0;
+  std::vector<float>        quantized;
+  for ( int level = Geometry::SIMD_SCALAR; level <= supported; ++level ) {
+    Geometry::setSimdLevel( (Geometry::SimdLevel)level );
+    glm::vec3 minPos, maxPos;
+    start = std::chrono::steady_clock::now();
+    Vec3Soa positions( vertices );
+    Geometry::computeBBox(
+      positions.size(), positions.x.data(), positions.y.data(), positions.z.data(), minPos, maxPos );
+    elapsed       = std::chrono::steady_clock::now() - start;
+    bool mismatch = std::memcmp( &minPos, &refMin, sizeof( glm::vec3 ) ) != 0
+                    || std::memcmp( &maxPos, &refMax, sizeof( glm::vec3 ) ) != 0;
+    std::cout << "computeBBox " << names[level] << ": " << elapsed.count() << " sec., "
+              << vertexCount / elapsed.count() / 1e6 << " Mvertices/sec" << ( mismatch ? ", mismatch" : "" )
+              << std::endl;
+    if ( mismatch ) status = 1;
+
+    start = std::chrono::steady_clock::now();
+    for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
+      Geometry::quantizeBatch( positions.size(), positions[c].data(), minPos[c], scale );
+    }
+    positions.toAos( quantized );
+    elapsed  = std::chrono::steady_clock::now() - start;
+    mismatch = std::memcmp( quantized.data(), refQuantized.data(), quantized.size() * sizeof( float ) ) != 0;
+    std::cout << "quantizeBatch " << names[level] << ": " << elapsed.count() << " sec., "
+              << vertexCount / elapsed.count() / 1e6 << " Mvertices/sec" << ( mismatch ? ", mismatch" : "" )
+              << std::endl;
+    if ( mismatch ) status = 1;
+  }
+  return status;
+}
@@ -0,0 +1,141 @@
+// ************* COPYRIGHT AND CONFIDENTIALITY INFORMATION *********
+// Copyright 2021 - InterDigital
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+// Author: jean-eudes.marvie@interdigital.com
+// *****************************************************************
+
+// micro benchmark of the ray triangle intersection on a single thread.
+// rows of axis aligned rays are thrown as in the grid sampling, once per ray with evalRayTriangle
+// and then by batch with evalRayTriangleBatch for each instruction set supported by the cpu.
+// usage: mmBenchRayTriangle [triangleCount [rowSize]]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+//
+#include "mmGeometry.h"
+
+using namespace mm;
+
+struct Triangle {
+  glm::vec3 v0, v1, v2;
+};
+
+// rays of a row along mainAxis, the row is at x on the second axis, starts at y0 on the third axis
+struct Row {
+  int   mainAxis;
+  float x, y0;
+};
+
+int main( int argc, char* argv[] ) {
+  const size_t triangleCount = argc > 1 ? std::atoi( argv[1] ) : 100000;
+  const size_t rowSize       = argc > 2 ? std::atoi( argv[2] ) : 32;
+  const float  step          = 1.0f / 256.0f;
+
+  // small random triangles in the unit box and a row of rays through the bbox of each
+  std::mt19937                          rng( 1 );
+  std::uniform_real_distribution<float> pos( 0.0f, 1.0f );
+  std::uniform_real_distribution<float> ofs( -0.5f * step * rowSize, 0.5f * step * rowSize );
+  std::vector<Triangle>                 triangles( triangleCount );
+  std::vector<Row>                      rows( triangleCount );
+  for ( size_t i = 0; i < triangleCount; ++i ) {
+    const glm::vec3 c( pos( rng ), pos( rng ), pos( rng ) );
+    triangles[i].v0 = c + glm::vec3( ofs( rng ), ofs( rng ), ofs( rng ) );
+    triangles[i].v1 = c + glm::vec3( ofs( rng ), ofs( rng ), ofs( rng ) );
+    triangles[i].v2 = c + glm::vec3( ofs( rng ), ofs( rng ), ofs( rng ) );
+    rows[i].mainAxis = i % 3;
+    rows[i].x        = std::floor( c[( i + 1 ) % 3] / step ) * step;
+    rows[i].y0       = std::floor( ( c[( i + 2 ) % 3] - 0.5f * step * rowSize ) / step ) * step;
+  }
+
+  std::vector<float>   origins[3] = { std::vector<float>( rowSize ), std::vector<float>( rowSize ),
+                                    std::vector<float>( rowSize ) };
+  std::vector<float>   t( triangleCount * rowSize ), u( triangleCount * rowSize ), v( triangleCount * rowSize );
+  std::vector<uint8_t> hits( triangleCount * rowSize );
+
+  // sets the origins of the rays of row i, returns the direction
+  auto setupRow = [&]( size_t i ) {
+    const Row& row    = rows[i];
+    glm::vec3  dir    = { 0.0, 0.0, 0.0 };
+    dir[row.mainAxis] = 1.0;
+    std::fill( origins[row.mainAxis].begin(), origins[row.mainAxis].end(), -1.0f );
+    std::fill( origins[( row.mainAxis + 1 ) % 3].begin(), origins[( row.mainAxis + 1 ) % 3].end(), row.x );
+    for ( size_t j = 0; j < rowSize; ++j ) origins[( row.mainAxis + 2 ) % 3][j] = row.y0 + j * step;
+    return dir;
+  };
+
+  // reference results, one ray at a time
+  std::vector<glm::vec3> refRes( triangleCount * rowSize );
+  std::vector<uint8_t>   refHits( triangleCount * rowSize );
+  size_t                 refHitCount = 0;
+  auto                   start       = std::chrono::steady_clock::now();
+  for ( size_t i = 0; i < triangleCount; ++i ) {
+    const glm::vec3 dir = setupRow( i );
+    for ( size_t j = 0; j < rowSize; ++j ) {
+      const glm::vec3 origin( origins[0][j], origins[1][j], origins[2][j] );
+      refHits[i * rowSize + j] = Geometry::evalRayTriangle(
+        origin, dir, triangles[i].v0, triangles[i].v1, triangles[i].v2, refRes[i * rowSize + j] );
+      refHitCount += refHits[i * rowSize + j];
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  const double                  rays    = (double)triangleCount * rowSize;
+  std::cout << "rays = " << rays << ", hits = " << refHitCount << std::endl;
+  std::cout << "evalRayTriangle: " << elapsed.count() << " sec., " << rays / elapsed.count() / 1e6 << " Mrays/sec"
+            << std::endl;
+
+  const char*               names[]   = { "scalar", "sse2", "avx2" };
+  const Geometry::SimdLevel supported = Geometry::getSimdLevel();
+  int                       status    = 0;
+  for ( int level = Geometry::SIMD_SCALAR; level <= supported; ++level ) {
+    Geometry::setSimdLevel( (Geometry::SimdLevel)level );
+    size_t hitCount = 0;
+    start           = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < triangleCount; ++i ) {
+      const glm::vec3 dir = setupRow( i );
+      hitCount += Geometry::evalRayTriangleBatch( dir,
+                                                  rowSize,
+                                                  origins[0].data(),
+                                                  origins[1].data(),
+                                                  origins[2].data(),
+                                                  triangles[i].v0,
+                                                  triangles[i].v1,
+                                                  triangles[i].v2,
+                                                  &t[i * rowSize],
+                                                  &u[i * rowSize],
+                                                  &v[i * rowSize],
+                                                  &hits[i * rowSize] );
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    // results must be bit exact with evalRayTriangle
+    size_t mismatches = 0;
+    for ( size_t k = 0; k < triangleCount * rowSize; ++k ) {
+      if ( hits[k] != refHits[k]
+           || ( hits[k]
+                && ( std::memcmp( &t[k], &refRes[k].x, sizeof( float ) )
+                     || std::memcmp( &u[k], &refRes[k].y, sizeof( float ) )
+                     || std::memcmp( &v[k], &refRes[k].z, sizeof( float ) ) ) ) )
+        ++mismatches;
+    }
+    std::cout << "evalRayTriangleBatch " << names[level] << ": " << elapsed.count() << " sec., "
+              << rays / elapsed.count() / 1e6 << " Mrays/sec, hits = " << hitCount << ", mismatches = " << mismatches
+              << std::endl;
+    if ( mismatches != 0 ) status = 1;
+  }
+  return status;
+}
@@ -64,6 +64,13 @@ class CmdAnalyse : Command {
   virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
   virtual bool process( uint32_t frame );
   virtual bool finalize();
+  virtual bool merge( Command* clone );
+  virtual void listFiles( std::vector<std::string>& inputModels,
+                          std::vector<std::string>& inputImages,
+                          std::vector<std::string>& outputs ) {
+    inputModels.push_back( _inputModelFilename );
+    inputImages.push_back( _inputTextureFilename );
+  }
 };
 
 #endif
@@ -32,6 +32,7 @@ class CmdCompare : Command {
   std::string _inputModelAFilename, _inputModelBFilename;
   std::string _inputTextureAFilename, _inputTextureBFilename;
   std::string _outputModelAFilename, _outputModelBFilename;
+  bool        _binaryPly = true;
   std::string _outputCsvFilename;
   // the type of processing
   std::string _mode = "equ";
@@ -88,6 +89,14 @@ class CmdCompare : Command {
   virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
   virtual bool process( uint32_t frame );  
   virtual bool finalize();
+  virtual bool merge( Command* clone );
+  virtual void listFiles( std::vector<std::string>& inputModels,
+                          std::vector<std::string>& inputImages,
+                          std::vector<std::string>& outputs ) {
+    inputModels.insert( inputModels.end(), { _inputModelAFilename, _inputModelBFilename } );
+    inputImages.insert( inputImages.end(), { _inputTextureAFilename, _inputTextureBFilename } );
+    outputs.insert( outputs.end(), { _outputModelAFilename, _outputModelBFilename } );
+  }
   
 };
 
@@ -25,9 +25,10 @@ class CmdDegrade : Command {
   // the command options
   std::string _inputModelFilename;
   std::string _outputModelFilename;
-  std::string _mode    = "delface";
-  size_t      _nthFace = 50;  // skip every nth face
-  size_t      _nbFaces = 0;   // if nthFace==0, skip number of faces
+  bool        _binaryPly = false;
+  std::string _mode      = "delface";
+  size_t      _nthFace   = 50;  // skip every nth face
+  size_t      _nbFaces   = 0;   // if nthFace==0, skip number of faces
 
  public:
   CmdDegrade(){};
@@ -42,6 +43,12 @@ class CmdDegrade : Command {
   virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
   virtual bool process( uint32_t frame );
   virtual bool finalize() { return true; };
+  virtual void listFiles( std::vector<std::string>& inputModels,
+                          std::vector<std::string>& inputImages,
+                          std::vector<std::string>& outputs ) {
+    inputModels.push_back( _inputModelFilename );
+    outputs.push_back( _outputModelFilename );
+  }
 
  private:
   size_t delNthFace( const mm::Model& input, size_t nthFace, mm::Model& output );
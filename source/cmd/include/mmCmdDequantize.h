@@ -37,11 +37,18 @@ class CmdDequantize : Command {
   virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
   virtual bool process( uint32_t frame );
   virtual bool finalize() { return true; };
+  virtual void listFiles( std::vector<std::string>& inputModels,
+                          std::vector<std::string>& inputImages,
+                          std::vector<std::string>& outputs ) {
+    inputModels.push_back( _inputModelFilename );
+    outputs.push_back( _outputModelFilename );
+  }
 
  private:
   // Command parameters
   std::string _inputModelFilename;
   std::string _outputModelFilename;
+  bool        _binaryPly = false;
   // Quantization parameters
   uint32_t _qp = 0;  // geometry
   uint32_t _qt = 0;  // UV coordinates
@@ -38,11 +38,20 @@ class CmdQuantize : Command {
   virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
   virtual bool process( uint32_t frame );
   virtual bool finalize() { return true; };
+  virtual void listFiles( std::vector<std::string>& inputModels,
+                          std::vector<std::string>& inputImages,
+                          std::vector<std::string>& outputs ) {
+    inputModels.push_back( _inputModelFilename );
+    outputs.push_back( _outputModelFilename );
+  }
 
  private:
+  // the context for frame access
+  Context* _context;
   // Command parameters
   std::string _inputModelFilename;
   std::string _outputModelFilename;
+  bool        _binaryPly = false;
   std::string _outputVarFilename;
   // Quantization parameters
   uint32_t _qp         = 12;  // geometry
@@ -80,6 +80,13 @@ class CmdRender : Command {
   virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
   virtual bool process( uint32_t frame );
   virtual bool finalize();
+  virtual void listFiles( std::vector<std::string>& inputModels,
+                          std::vector<std::string>& inputImages,
+                          std::vector<std::string>& outputs ) {
+    inputModels.push_back( inputModelFilename );
+    inputImages.push_back( inputTextureFilename );
+    outputs.insert( outputs.end(), { outputImageFilename, outputDepthFilename } );
+  }
 };
 
 #endif
\ No newline at end of file
@@ -32,8 +32,10 @@ class CmdSample : Command {
   std::string inputModelFilename;
   std::string inputTextureFilename;
   std::string outputModelFilename;
+  bool        _binaryPly = false;
   std::string _outputCsvFilename;
   bool        hideProgress = false;
+  int         _threads     = 0;
   // the type of processing
   std::string mode = "face";
   // Face options
@@ -42,6 +44,7 @@ class CmdSample : Command {
   int         _gridSize      = 1024;
   bool        _useNormal     = false;
   bool        _useFixedPoint = false;
+  std::string _gridMethod    = "ray";
   std::string _minPosStr;
   std::string _maxPosStr;
   glm::vec3   _minPos = {0.0F, 0.0F, 0.0F};
@@ -59,6 +62,8 @@ class CmdSample : Command {
   size_t _nbSamplesMin  = 0;
   size_t _nbSamplesMax  = 0;
   size_t _maxIterations = 10;
+  // count the points without generating them
+  bool _countOnly = false;
   // Prnd options
   size_t _nbSamples = 2000000;
 
@@ -75,6 +80,13 @@ class CmdSample : Command {
   virtual bool initialize( Context* ctx, std::string app, int argc, char* argv[] );
   virtual bool process( uint32_t frame );
   virtual bool finalize() { return true; }
+  virtual void listFiles( std::vector<std::string>& inputModels,
+                          std::vector<std::string>& inputImages,
+                          std::vector<std::string>& outputs ) {
+    inputModels.push_back( inputModelFilename );
+    inputImages.push_back( inputTextureFilename );
+    outputs.push_back( outputModelFilename );
+  }
 };
 
 #endif
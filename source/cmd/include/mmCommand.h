@@ -20,8 +20,10 @@
 #define _MM_CMD_COMMAND_H_
 
 #include <string>
+#include <vector>
 #include <map>
 #include <iostream>
+#include <fstream>
 #include <sstream>
 
 // mathematics
@@ -29,11 +31,17 @@
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
+// argument parsing
+#include <cxxopts.hpp>
+
 //
 #include "mmContext.h"
 
 class Command {
  public:  // Command API, to be specialized by command implementation
+  // commands are deleted through this base, e.g. the clones of the frame parallel mode
+  virtual ~Command() {}
+
   // must be overloaded to parse arguments and init the command
   virtual bool initialize( Context*, std::string app, int argc, char* argv[] ) = 0;
 
@@ -43,6 +51,16 @@ class Command {
   // must be overloaded to collect temporal results after all frames processing
   virtual bool finalize( void ) = 0;
 
+  // can be overloaded to list the file name templates of the input models and images,
+  // and of the output files of the command. Used to prefetch the inputs of next frames.
+  virtual void listFiles( std::vector<std::string>& inputModels,
+                          std::vector<std::string>& inputImages,
+                          std::vector<std::string>& outputs ) {}
+
+  // can be overloaded to collect the temporal results of a clone of the command, that processed
+  // other frames of the sequence in frame parallel mode. Invoked before finalize, clone is then deleted.
+  virtual bool merge( Command* clone ) { return true; }
+
  public:  // Command managment API
   // command creator function type
   typedef Command* ( *Creator )( void );
@@ -101,4 +119,50 @@ inline bool parseVec4( const std::string& s, glm::vec4& res ) {
   } catch ( std::istringstream::failure ) { return false; }
 }
 
+// parses a ply output format in [ascii,binary]
+inline bool parsePlyFormat( const std::string& s, bool& binary ) {
+  if ( s != "ascii" && s != "binary" ) return false;
+  binary = s == "binary";
+  return true;
+}
+
+// sets binary from the plyFormat option if given, prints an error and returns false if the format is invalid
+inline bool parsePlyFormatOption( const cxxopts::ParseResult& result, bool& binary ) {
+  if ( !result.count( "plyFormat" ) ) return true;
+  const std::string format = result["plyFormat"].as<std::string>();
+  if ( parsePlyFormat( format, binary ) ) return true;
+  std::cerr << "Error: invalid plyFormat \"" << format << "\"" << std::endl;
+  return false;
+}
+
+// appends a row to a csv file, the header is written first if the file is empty or does not exist.
+// if truncate is true the file content is discarded before.
+inline void appendCsvRow( const std::string& filename,
+                          const std::string& header,
+                          const std::string& row,
+                          const bool         truncate = false ) {
+  std::streamoff fileSize = 0;
+  if ( !truncate ) {
+    std::ifstream fileIn( filename, std::ios::binary | std::ios::ate );
+    if ( fileIn ) fileSize = fileIn.tellg();
+  }
+  std::ofstream fileOut( filename, truncate ? std::ios::out : std::ios::out | std::ios::app );
+  if ( !fileOut ) {
+    std::cout << "Error: could not open output file " << filename << std::endl;
+    return;
+  }
+  if ( fileSize == 0 ) fileOut << header << std::endl;
+  fileOut << row << std::endl;
+}
+
+// appends the row of the frame to a csv file in frame order, see Context::commit
+inline void commitCsvRow( Context*           context,
+                          const uint32_t     frame,
+                          const std::string& filename,
+                          const std::string& header,
+                          const std::string& row,
+                          const bool         truncate = false ) {
+  context->commit( frame, [=]() { appendCsvRow( filename, header, row, truncate ); } );
+}
+
 #endif
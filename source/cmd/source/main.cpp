@@ -20,6 +20,12 @@
 #include <iostream>
 #include <vector>
 #include <limits>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
 #include <time.h>
 
 // internal headers
@@ -48,6 +54,38 @@
 #include "mmCmdNormals.h"
 #include "mmCmdRender.h"
 
+// stream buffer of std::cout for the frame parallel mode. the messages of each lane are kept in a
+// buffer of its thread and written at once when its frame is done, so that the logs of the frames
+// processed concurrently do not interleave.
+class FrameLog : public std::streambuf {
+ public:
+  FrameLog( std::streambuf* output ) : _output( output ) {}
+
+  // writes the messages of the calling thread to the output
+  void flushFrame( void ) {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _output->sputn( _buffer.data(), _buffer.size() );
+    _output->pubsync();
+    _buffer.clear();
+  }
+
+ protected:
+  int_type overflow( int_type c ) override {
+    if ( !traits_type::eq_int_type( c, traits_type::eof() ) ) _buffer.push_back( traits_type::to_char_type( c ) );
+    return traits_type::not_eof( c );
+  }
+  std::streamsize xsputn( const char* s, std::streamsize n ) override {
+    _buffer.append( s, (size_t)n );
+    return n;
+  }
+
+ private:
+  std::streambuf*                 _output;
+  std::mutex                      _mutex;
+  static thread_local std::string _buffer;
+};
+thread_local std::string FrameLog::_buffer;
+
 // analyse command line and run processings
 int main( int argc, char* argv[] ) {
   // this is mandatory to print floats with full precision
@@ -75,6 +113,9 @@ int main( int argc, char* argv[] ) {
     mm::IO::setContext( &context );
     // set of commands to be executer in order
     std::vector<Command*> commands;
+    // copy of the arguments of each command, to create clones in frame parallel mode.
+    // copied before initialization since options parsing may alter argv.
+    std::vector<std::vector<std::string>> commandArgs;
 
     // 1 - initialize the command list
     int startIdx = 1;
@@ -94,6 +135,7 @@ int main( int argc, char* argv[] ) {
       Command* newCmd = NULL;
       if ( ( newCmd = Command::create( APP_NAME, std::string( argv[startIdx] ) ) ) == NULL ) { return 1; }
       commands.push_back( newCmd );
+      commandArgs.push_back( std::vector<std::string>( &argv[startIdx], &argv[startIdx + subArgc] ) );
 
       // initialize the command
       if ( !newCmd->initialize( &context, APP_NAME, subArgc, &argv[startIdx] ) ) { return 1; }
@@ -103,16 +145,103 @@ int main( int argc, char* argv[] ) {
 
     } while ( startIdx < argc );
 
+    // input and output files of the commands, to prefetch the inputs of next frames.
+    // inputs that are written by the processing of frames not yet completed are not prefetched.
+    // the inputs and outputs of each command are also used to release the models and images of
+    // a frame as soon as the last command that reads them is done.
+    std::vector<std::string>              inputModels, inputImages, outputs;
+    std::vector<std::vector<std::string>> cmdInputs( commands.size() ), cmdOutputs( commands.size() );
+    std::vector<std::string>              allInputs;
+    for ( size_t cmdIndex = 0; cmdIndex < commands.size(); ++cmdIndex ) {
+      std::vector<std::string> models, images;
+      commands[cmdIndex]->listFiles( models, images, cmdOutputs[cmdIndex] );
+      cmdInputs[cmdIndex] = models;
+      cmdInputs[cmdIndex].insert( cmdInputs[cmdIndex].end(), images.begin(), images.end() );
+      inputModels.insert( inputModels.end(), models.begin(), models.end() );
+      inputImages.insert( inputImages.end(), images.begin(), images.end() );
+      outputs.insert( outputs.end(), cmdOutputs[cmdIndex].begin(), cmdOutputs[cmdIndex].end() );
+      allInputs.insert( allInputs.end(), cmdInputs[cmdIndex].begin(), cmdInputs[cmdIndex].end() );
+    }
+    auto isProduced = [&]( const std::string& input, uint32_t frame, uint32_t next ) {
+      const std::string name = mm::IO::resolveName( next, input );
+      for ( const auto& output : outputs ) {
+        for ( uint32_t f = frame; f <= next; ++f ) {
+          if ( mm::IO::resolveName( f, output ) == name ) return true;
+        }
+      }
+      return false;
+    };
+
     // 2 - execute each command for each frame
-    int procErrors = 0;
-    for ( uint32_t frame = context.getFirstFrame(); frame <= context.getLastFrame(); ++frame ) {
-      std::cout << "Processing frame " << frame << std::endl;
-      context.setFrame( frame );
-      for ( size_t cmdIndex = 0; cmdIndex < commands.size(); ++cmdIndex ) {
-        if ( !commands[cmdIndex]->process( frame ) ) { procErrors++; }
+    std::atomic<int> procErrors( 0 );
+    // runs the commands on the current frame of the calling thread
+    auto processCommands = [&]( uint32_t frame, std::vector<Command*>& frameCommands ) {
+      mm::IO::setUses( allInputs );
+      for ( size_t cmdIndex = 0; cmdIndex < frameCommands.size(); ++cmdIndex ) {
+        if ( !frameCommands[cmdIndex]->process( frame ) ) { procErrors++; }
+        mm::IO::release( cmdInputs[cmdIndex], cmdOutputs[cmdIndex] );
       }
       // purge the models, clean IO for next frame
       mm::IO::purge();
+    };
+    const uint32_t lanes = std::min( context.getFrameParallel(), context.getFrameCount() );
+    if ( lanes <= 1 ) {
+      for ( uint32_t frame = context.getFirstFrame(); frame <= context.getLastFrame(); ++frame ) {
+        std::cout << "Processing frame " << frame << std::endl;
+        context.setFrame( frame );
+        // start loading the inputs of the next frames
+        const uint32_t lastPrefetch = std::min( context.getLastFrame(), frame + context.getPrefetchDepth() );
+        for ( uint32_t next = frame + 1; next <= lastPrefetch; ++next ) {
+          std::vector<std::string> models, images;
+          for ( const auto& input : inputModels )
+            if ( !isProduced( input, frame, next ) ) models.push_back( input );
+          for ( const auto& input : inputImages )
+            if ( !isProduced( input, frame, next ) ) images.push_back( input );
+          mm::IO::prefetch( next, models, images, context.getPrefetchDepth(), context.getPrefetchMemory() );
+        }
+        processCommands( frame, commands );
+        context.setFrameDone( frame );
+      }
+    } else {
+      // frame parallel, each lane is a thread processing frames with its own instances of the commands
+      // and its own IO store. frames are taken in increasing order.
+      std::vector<std::vector<Command*>> laneCommands( lanes );
+      laneCommands[0] = commands;
+      for ( uint32_t lane = 1; lane < lanes; ++lane ) {
+        for ( size_t cmdIndex = 0; cmdIndex < commands.size(); ++cmdIndex ) {
+          std::vector<std::string> args = commandArgs[cmdIndex];
+          std::vector<char*>       cmdArgv;
+          for ( auto& arg : args ) cmdArgv.push_back( &arg[0] );
+          Command* clone = Command::create( APP_NAME, args[0] );
+          if ( clone == NULL || !clone->initialize( &context, APP_NAME, (int)cmdArgv.size(), cmdArgv.data() ) ) {
+            return 1;
+          }
+          laneCommands[lane].push_back( clone );
+        }
+      }
+      FrameLog              frameLog( std::cout.rdbuf() );
+      std::atomic<uint32_t> nextFrame( context.getFirstFrame() );
+      auto                  processFrames = [&]( uint32_t lane ) {
+        for ( uint32_t frame = nextFrame++; frame <= context.getLastFrame(); frame = nextFrame++ ) {
+          std::cout << "Processing frame " << frame << std::endl;
+          context.setFrame( frame );
+          processCommands( frame, laneCommands[lane] );
+          context.setFrameDone( frame );
+          frameLog.flushFrame();
+        }
+      };
+      std::streambuf*          output = std::cout.rdbuf( &frameLog );
+      std::vector<std::thread> threads;
+      for ( uint32_t lane = 0; lane < lanes; ++lane ) threads.push_back( std::thread( processFrames, lane ) );
+      for ( auto& thread : threads ) thread.join();
+      std::cout.rdbuf( output );
+      // collect the temporal results of the clones
+      for ( uint32_t lane = 1; lane < lanes; ++lane ) {
+        for ( size_t cmdIndex = 0; cmdIndex < commands.size(); ++cmdIndex ) {
+          if ( !commands[cmdIndex]->merge( laneCommands[lane][cmdIndex] ) ) { procErrors++; }
+          delete laneCommands[lane][cmdIndex];
+        }
+      }
     }
     if ( procErrors != 0 ) { std::cerr << "There was " << procErrors << " processing errors" << std::endl; }
 
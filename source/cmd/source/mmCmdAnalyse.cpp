@@ -98,18 +98,6 @@ bool CmdAnalyse::process( uint32_t frame ) {
     if ( ( inputModel = mm::IO::loadModel( _inputModelFilename ) ) == NULL ) { return false; }
   }
 
-  // create or open in append mode output csv if needed
-  std::ofstream fout;
-  if ( _outputCsvFilename != "" ) {
-    if ( frame == _context->getFirstFrame() ) {
-      fout.open( _outputCsvFilename.c_str(), std::ios::out );
-    } else {
-      fout.open( _outputCsvFilename.c_str(), std::ios::out | std::ofstream::app );
-    }
-    // this is mandatory to print floats with full precision
-    fout.precision( std::numeric_limits<float>::max_digits10 );
-  }
-
   // Perform the processings
   clock_t t1 = clock();
 
@@ -151,21 +139,22 @@ bool CmdAnalyse::process( uint32_t frame ) {
   if ( textureMap != NULL ) {}
 
   // print to output csv if needed
-  if ( fout ) {
-    // print the header if needed
-    if ( frame == _context->getFirstFrame() ) {
-      fout << "frame";
-      if ( inputModel != NULL ) {
-        fout << ";triangles;vertices;uvcoords;colors;normals"
+  // the file is restarted at first frame
+  if ( _outputCsvFilename != "" ) {
+    std::ostringstream header, fout;
+    // this is mandatory to print floats with full precision
+    fout.precision( std::numeric_limits<float>::max_digits10 );
+    // the header
+    header << "frame";
+    if ( inputModel != NULL ) {
+      header << ";triangles;vertices;uvcoords;colors;normals"
              << ";minPosX;minPosY;minPosZ;maxPosX;maxPosY;maxPosZ"
              << ";minU;minV;maxU;maxV"
              << ";minColR;minColG;minColB;maxColR;maxColB;maxColB"
              << ";minNrmY;minNrmY;minNrmZ;maxNrmY;maxNrmY;maxNrmZ";
-      }
-      if ( textureMap != NULL ) {
-        fout << "";  // nothing yet
-      }
-      fout << std::endl;
+    }
+    if ( textureMap != NULL ) {
+      header << "";  // nothing yet
     }
     // print stats
     fout << frame;
@@ -186,9 +175,9 @@ bool CmdAnalyse::process( uint32_t frame ) {
              << maxNrm[2];
       } else fout << ";;;;;;";
     }
-    fout << std::endl;
     // done
-    fout.close();
+    commitCsvRow(
+      _context, frame, _outputCsvFilename, header.str(), fout.str(), frame == _context->getFirstFrame() );
   }
 
   // done
@@ -199,6 +188,19 @@ bool CmdAnalyse::process( uint32_t frame ) {
   return true;
 }
 
+bool CmdAnalyse::merge( Command* clone ) {
+  CmdAnalyse* other = static_cast<CmdAnalyse*>( clone );
+  _counts.insert( _counts.end(), other->_counts.begin(), other->_counts.end() );
+  std::stable_sort( _counts.begin(), _counts.end(), []( const auto& a, const auto& b ) {
+    return std::get<0>( a ) < std::get<0>( b );
+  } );
+  mm::Geometry::computeBBox( _minPos, _maxPos, other->_minPos, other->_maxPos, _minPos, _maxPos );
+  mm::Geometry::computeBBox( _minNrm, _maxNrm, other->_minNrm, other->_maxNrm, _minNrm, _maxNrm );
+  mm::Geometry::computeBBox( _minCol, _maxCol, other->_minCol, other->_maxCol, _minCol, _maxCol );
+  mm::Geometry::computeBBox( _minUv, _maxUv, other->_minUv, other->_maxUv, _minUv, _maxUv );
+  return true;
+}
+
 bool CmdAnalyse::finalize() {
   std::vector<std::ostream*> out;
   out.push_back( &std::cout );
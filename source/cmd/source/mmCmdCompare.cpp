@@ -78,6 +78,8 @@ bool CmdCompare::initialize( Context* context, std::string app, int argc, char*
 				cxxopts::value<std::string>())
 			("outputModelB", "path to output model B (obj or ply file)",
 				cxxopts::value<std::string>())
+			("plyFormat", "output format of ply files in [ascii,binary]",
+				cxxopts::value<std::string>()->default_value("binary"))
 			("outputCsv", "filename of the file where per frame statistics will append.",
 				cxxopts::value<std::string>()->default_value(""))
 			("mode", "the comparison mode in [equ,pcc,pcqm,topo,ibsm]",
@@ -181,6 +183,7 @@ bool CmdCompare::initialize( Context* context, std::string app, int argc, char*
     // Optional
     if ( result.count( "outputModelA" ) ) _outputModelAFilename = result["outputModelA"].as<std::string>();
     if ( result.count( "outputModelB" ) ) _outputModelBFilename = result["outputModelB"].as<std::string>();
+    if ( !parsePlyFormatOption( result, _binaryPly ) ) return false;
     // eq
     if ( result.count( "epsilon" ) ) _equEpsilon = result["epsilon"].as<float>();
     if ( result.count( "earlyReturn" ) ) _equEarlyReturn = result["earlyReturn"].as<bool>();
@@ -226,40 +229,15 @@ bool CmdCompare::initialize( Context* context, std::string app, int argc, char*
     return false;
   }
 
-  return true;
-}
+  // the OpenGL context is bound to the thread that creates it, frame lanes can't share it
+  if ( _mode == "ibsm" && _ibsmRenderer == "gl12_raster" && _context->getFrameParallel() > 1 ) {
+    std::cerr << "Error: the gl12_raster renderer requires frameParallel = 1" << std::endl;
+    return false;
+  }
 
-// func to be moved into a mmFileUtility.cpp/h or in IO.h
-// open output text file in append mode with proper float precision
-std::ofstream& openOutputFile( const std::string& fileName, std::ofstream& fileOut ) {
-  // let's open in append write mode
-  fileOut.open( fileName.c_str(), std::ios::out | std::ofstream::app );
-  // this is mandatory to print floats with full precision
-  fileOut.precision( std::numeric_limits<float>::max_digits10 );
-  //
-  return fileOut;
+  return true;
 }
 
-// func to be moved into a mmFileUtility.cpp/h or in IO.h
-// this version will check file size in addition to opening the text file for output
-std::ofstream& openOutputFile( const std::string& fileName, std::ofstream& fileOut, std::streamoff& fileSize ) {
-  // create or open in append mode output csv if needed
-  fileSize = 0;
-  if ( fileName != "" ) {
-    // check if csv file is empty, need to open in read mode
-    std::ifstream fileIn;
-    fileIn.open( fileName, std::ios::binary );
-    if ( fileIn ) {
-      fileIn.seekg( 0, std::ios::end );
-      fileSize = fileIn.tellg();
-      fileIn.close();
-    }
-    openOutputFile( fileName.c_str(), fileOut );
-  }
-  //
-  return fileOut;
-};
-
 bool CmdCompare::process( uint32_t frame ) {
   // Reading map if needed
   mm::Image *textureMapA, *textureMapB;
@@ -296,18 +274,19 @@ bool CmdCompare::process( uint32_t frame ) {
     return false;
   }
 
+  // intermediate models that no other command reads are consumed by the sampling metrics instead of copied.
+  // a model given as both inputs is read twice, thus never movable.
+  const bool movableA = mm::IO::isMovable( _inputModelAFilename );
+  const bool movableB = mm::IO::isMovable( _inputModelBFilename );
+
   // the output models if any
   mm::Model* outputModelA = new mm::Model();
   mm::Model* outputModelB = new mm::Model();
   int        res          = 2;
 
-  // create or open in append mode output csv if needed
-  std::streamoff csvFileLength = 0;
-  std::ofstream  csvFileOut;
-  openOutputFile( _outputCsvFilename, csvFileOut, csvFileLength );
-
   // Perform the processings
   clock_t t1 = clock();
+  _compare.setFrameIndex( frame - _context->getFirstFrame() );
   if ( _mode == "equ" ) {
     std::cout << "Compare models for equality" << std::endl;
     std::cout << "  Epsilon = " << _equEpsilon << std::endl;
@@ -322,20 +301,16 @@ bool CmdCompare::process( uint32_t frame ) {
                         *outputModelB );
 
     // print the stats
-    if ( csvFileOut ) {
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "modelA;textureA;modelB;textureB;frame;epsilon;earlyReturn;unoriented;meshEquality;textureDiffs"
-                   << std::endl;
-      }
-      // print stats
-      csvFileOut << _inputModelAFilename << ";" << _inputTextureAFilename << ";" << _inputModelBFilename << ";"
-                 << _inputTextureBFilename << ";" << frame << ";" << _equEpsilon << ";" << _equEarlyReturn << ";"
-                 << _equUnoriented << ";"
-                 << "TODO"
-                 << "TODO" << std::endl;
-      // done
-      csvFileOut.close();
+    if ( _outputCsvFilename != "" ) {
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "modelA;textureA;modelB;textureB;frame;epsilon;earlyReturn;unoriented;meshEquality;textureDiffs";
+      row << _inputModelAFilename << ";" << _inputTextureAFilename << ";" << _inputModelBFilename << ";"
+          << _inputTextureBFilename << ";" << frame << ";" << _equEpsilon << ";" << _equEarlyReturn << ";"
+          << _equUnoriented << ";"
+          << "TODO"
+          << "TODO";
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else if ( _mode == "topo" ) {
     std::cout << "Compare models topology for equivalence" << std::endl;
@@ -346,18 +321,15 @@ bool CmdCompare::process( uint32_t frame ) {
     res = _compare.topo( *inputModelA, *inputModelB, faceMapFilenameResolved, vertexMapFilenameResolved );
 
     // print the stats
-    if ( csvFileOut ) {
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "modelA;textureA;modelB;textureB;faceMap;vertexMap;frame;equivalence" << std::endl;
-      }
-      // print stats
-      csvFileOut << _inputModelAFilename << ";" << _inputTextureAFilename << ";" << _inputModelBFilename << ";"
-                 << _inputTextureBFilename << ";" << faceMapFilenameResolved << ";" << vertexMapFilenameResolved << ";"
-                 << frame << ";"
-                 << "TODO" << std::endl;
-      // done
-      csvFileOut.close();
+    if ( _outputCsvFilename != "" ) {
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "modelA;textureA;modelB;textureB;faceMap;vertexMap;frame;equivalence";
+      row << _inputModelAFilename << ";" << _inputTextureAFilename << ";" << _inputModelBFilename << ";"
+          << _inputTextureBFilename << ";" << faceMapFilenameResolved << ";" << vertexMapFilenameResolved << ";"
+          << frame << ";"
+          << "TODO";
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else if ( _mode == "pcc" ) {
     std::cout << "Compare models using MPEG PCC distortion metric" << std::endl;
@@ -371,68 +343,72 @@ bool CmdCompare::process( uint32_t frame ) {
 
     // just backup for logging because it might be modified by pcc function call if auto mode
     float paramsResolution = _pccParams.resolution;
-    res =
-      _compare.pcc( *inputModelA, *inputModelB, *textureMapA, *textureMapB, _pccParams, *outputModelA, *outputModelB );
+    res = _compare.pcc( *inputModelA,
+                        *inputModelB,
+                        *textureMapA,
+                        *textureMapB,
+                        _pccParams,
+                        *outputModelA,
+                        *outputModelB,
+                        true,
+                        movableA,
+                        movableB );
 
     // print the stats
     // TODO add all parameters in the output
-    if ( csvFileOut ) {
+    if ( _outputCsvFilename != "" ) {
       // retrieve  metric results
       auto& frameResults = _compare.getPccResults();
 
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "p_inputModelA;"
-                   << "p_inputModelB;"
-                   << "p_inputMapA;"
-                   << "p_inputMapB;"
-                   << "p_singlePass;"
-                   << "p_hausdorff;"
-                   << "p_color;"
-                   << "p_resolution;"
-                   << "p_neighborsProc;"
-                   << "p_dropDuplicates;"
-                   << "p_averageNormals;"
-                   << "frame;"
-                   << "resolution;"
-                   << "c2c_psnr;"
-                   << "haus_c2c_psnr;"
-                   << "c2p_psnr;"
-                   << "hausc2p_psnr;"
-                   << "color_psnr[0];"
-                   << "color_psnr[1];"
-                   << "color_psnr[2];"
-                   << "haus_rgb_psnr[0];"
-                   << "haus_rgb_psnr[1];"
-                   << "haus_rgb_psnr[2]" << std::endl;
-      }
-      // print stats
-      csvFileOut << _inputModelAFilename << ";"                             // inputModelA
-                 << _inputModelBFilename << ";"                             // inputModelB
-                 << _inputTextureAFilename << ";"                           // inputMapA
-                 << _inputTextureBFilename << ";"                           // inputMapB
-                 << _pccParams.singlePass << ";"                            // singlePass
-                 << _pccParams.hausdorff << ";"                             // hausdorff
-                 << _pccParams.bColor << ";"                                // color
-                 << paramsResolution << ";"                                 // resolution
-                 << _pccParams.neighborsProc << ";"                         // neighborsProc
-                 << _pccParams.dropDuplicates << ";"                        // dropDuplicates
-                 << _pccParams.bAverageNormals << ";"                       // averageNormals
-                 << frame << ";"                                            // frame
-                 << _pccParams.resolution << ";"                            // resolution
-                 << frameResults.second.c2c_psnr << ";"                     // c2c_psnr
-                 << frameResults.second.c2c_hausdorff_psnr << ";"           // haus_c2c_psnr
-                 << frameResults.second.c2p_psnr << ";"                     // c2p_psnr
-                 << frameResults.second.c2p_hausdorff_psnr << ";"           // hausc2p_psnr
-                 << frameResults.second.color_psnr[0] << ";"                // color_psnr[0]
-                 << frameResults.second.color_psnr[1] << ";"                // color_psnr[1]
-                 << frameResults.second.color_psnr[2] << ";"                // color_psnr[2]
-                 << frameResults.second.color_rgb_hausdorff_psnr[0] << ";"  // haus_rgb_psnr[0]
-                 << frameResults.second.color_rgb_hausdorff_psnr[1] << ";"  // haus_rgb_psnr[1]
-                 << frameResults.second.color_rgb_hausdorff_psnr[2]         // haus_rgb_psnr[2]
-                 << std::endl;
-      // done
-      csvFileOut.close();
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "p_inputModelA;"
+             << "p_inputModelB;"
+             << "p_inputMapA;"
+             << "p_inputMapB;"
+             << "p_singlePass;"
+             << "p_hausdorff;"
+             << "p_color;"
+             << "p_resolution;"
+             << "p_neighborsProc;"
+             << "p_dropDuplicates;"
+             << "p_averageNormals;"
+             << "frame;"
+             << "resolution;"
+             << "c2c_psnr;"
+             << "haus_c2c_psnr;"
+             << "c2p_psnr;"
+             << "hausc2p_psnr;"
+             << "color_psnr[0];"
+             << "color_psnr[1];"
+             << "color_psnr[2];"
+             << "haus_rgb_psnr[0];"
+             << "haus_rgb_psnr[1];"
+             << "haus_rgb_psnr[2]";
+      row << _inputModelAFilename << ";"                             // inputModelA
+          << _inputModelBFilename << ";"                             // inputModelB
+          << _inputTextureAFilename << ";"                           // inputMapA
+          << _inputTextureBFilename << ";"                           // inputMapB
+          << _pccParams.singlePass << ";"                            // singlePass
+          << _pccParams.hausdorff << ";"                             // hausdorff
+          << _pccParams.bColor << ";"                                // color
+          << paramsResolution << ";"                                 // resolution
+          << _pccParams.neighborsProc << ";"                         // neighborsProc
+          << _pccParams.dropDuplicates << ";"                        // dropDuplicates
+          << _pccParams.bAverageNormals << ";"                       // averageNormals
+          << frame << ";"                                            // frame
+          << _pccParams.resolution << ";"                            // resolution
+          << frameResults.second.c2c_psnr << ";"                     // c2c_psnr
+          << frameResults.second.c2c_hausdorff_psnr << ";"           // haus_c2c_psnr
+          << frameResults.second.c2p_psnr << ";"                     // c2p_psnr
+          << frameResults.second.c2p_hausdorff_psnr << ";"           // hausc2p_psnr
+          << frameResults.second.color_psnr[0] << ";"                // color_psnr[0]
+          << frameResults.second.color_psnr[1] << ";"                // color_psnr[1]
+          << frameResults.second.color_psnr[2] << ";"                // color_psnr[2]
+          << frameResults.second.color_rgb_hausdorff_psnr[0] << ";"  // haus_rgb_psnr[0]
+          << frameResults.second.color_rgb_hausdorff_psnr[1] << ";"  // haus_rgb_psnr[1]
+          << frameResults.second.color_rgb_hausdorff_psnr[2];        // haus_rgb_psnr[2]
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else if ( _mode == "pcqm" ) {
     std::cout << "Compare models using PCQM distortion metric" << std::endl;
@@ -447,26 +423,26 @@ bool CmdCompare::process( uint32_t frame ) {
                          _pcqmThresholdKnnSearch,
                          _pcqmRadiusFactor,
                          *outputModelA,
-                         *outputModelB );
+                         *outputModelB,
+                         true,
+                         movableA,
+                         movableB );
     // print the stats
     // TODO add all parameters in the output
-    if ( csvFileOut ) {
+    if ( _outputCsvFilename != "" ) {
       // retrieve  metric results
       auto& frameResults = _compare.getPcqmResults();
 
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "p_inputModelA;p_inputModelB;p_inputMapA;p_inputMapB;"
-                   << "p_radiusCurvature;p_thresholdKnnSearch;p_radiusFactor;"
-                   << "frame;pcqm;pcqm_psnr" << std::endl;
-      }
-      // print stats
-      csvFileOut << _inputModelAFilename << ";" << _inputModelBFilename << ";" << _inputTextureAFilename << ";"
-                 << _inputTextureBFilename << ";" << _pcqmRadiusCurvature << ";" << _pcqmThresholdKnnSearch << ";"
-                 << _pcqmRadiusFactor << ";" << frame << ";" << (double)std::get<1>( frameResults ) << ";"
-                 << (double)std::get<2>( frameResults ) << std::endl;
-      // done
-      csvFileOut.close();
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "p_inputModelA;p_inputModelB;p_inputMapA;p_inputMapB;"
+             << "p_radiusCurvature;p_thresholdKnnSearch;p_radiusFactor;"
+             << "frame;pcqm;pcqm_psnr";
+      row << _inputModelAFilename << ";" << _inputModelBFilename << ";" << _inputTextureAFilename << ";"
+          << _inputTextureBFilename << ";" << _pcqmRadiusCurvature << ";" << _pcqmThresholdKnnSearch << ";"
+          << _pcqmRadiusFactor << ";" << frame << ";" << (double)std::get<1>( frameResults ) << ";"
+          << (double)std::get<2>( frameResults );
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else if ( _mode == "ibsm" ) {
     std::cout << "Compare models using IBSM distortion metric" << std::endl;
@@ -492,30 +468,27 @@ bool CmdCompare::process( uint32_t frame ) {
                          *outputModelB );
 
     // print the stats
-    if ( csvFileOut ) {
+    if ( _outputCsvFilename != "" ) {
       // retrieve  metric results
       auto& frameResults = _compare.getIbsmResults();
 
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "p_inputModelA;p_inputModelB;p_inputMapA;p_inputMapB;"
-                   << "p_ibsmRenderer;p_ibsmCameraCount;p_ibsmCameraRotation;p_ibsmResolution;"
-                   << "p_ibsmDisableCulling;p_ibsmOutputPrefix;"
-                   << "frame;geo_psnr;rgb_psnr;r_psnr;g_psnr;b_psnr;"
-                   << "yuv_psnr;y_psnr;u_psnr;v_psnr;processingTime" << std::endl;
-      }
-      // print stats
-      csvFileOut << _inputModelAFilename << ";" << _inputModelBFilename << ";" << _inputTextureAFilename << ";"
-                 << _inputTextureBFilename << ";" << _ibsmRenderer << ";" << _ibsmCameraCount << ";"
-                 << _ibsmCameraRotation << ";" << _ibsmResolution << ";" << _ibsmDisableCulling << ";"
-                 << _ibsmOutputPrefix << ";" << frame << ";" << frameResults.second.depthPSNR << ";"
-                 << frameResults.second.rgbPSNR[3] << ";" << frameResults.second.rgbPSNR[0] << ";"
-                 << frameResults.second.rgbPSNR[1] << ";" << frameResults.second.rgbPSNR[2] << ";"
-                 << frameResults.second.yuvPSNR[3] << ";" << frameResults.second.yuvPSNR[0] << ";"
-                 << frameResults.second.yuvPSNR[1] << ";" << frameResults.second.yuvPSNR[2] << ";"
-                 << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC << std::endl;
-      // done
-      csvFileOut.close();
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "p_inputModelA;p_inputModelB;p_inputMapA;p_inputMapB;"
+             << "p_ibsmRenderer;p_ibsmCameraCount;p_ibsmCameraRotation;p_ibsmResolution;"
+             << "p_ibsmDisableCulling;p_ibsmOutputPrefix;"
+             << "frame;geo_psnr;rgb_psnr;r_psnr;g_psnr;b_psnr;"
+             << "yuv_psnr;y_psnr;u_psnr;v_psnr;processingTime";
+      row << _inputModelAFilename << ";" << _inputModelBFilename << ";" << _inputTextureAFilename << ";"
+          << _inputTextureBFilename << ";" << _ibsmRenderer << ";" << _ibsmCameraCount << ";"
+          << _ibsmCameraRotation << ";" << _ibsmResolution << ";" << _ibsmDisableCulling << ";"
+          << _ibsmOutputPrefix << ";" << frame << ";" << frameResults.second.depthPSNR << ";"
+          << frameResults.second.rgbPSNR[3] << ";" << frameResults.second.rgbPSNR[0] << ";"
+          << frameResults.second.rgbPSNR[1] << ";" << frameResults.second.rgbPSNR[2] << ";"
+          << frameResults.second.yuvPSNR[3] << ";" << frameResults.second.yuvPSNR[0] << ";"
+          << frameResults.second.yuvPSNR[1] << ";" << frameResults.second.yuvPSNR[2] << ";"
+          << ( (float)( clock() - t1 ) ) / CLOCKS_PER_SEC;
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else {
     std::cerr << "Error: invalid --mode " << _mode << std::endl;
@@ -526,13 +499,13 @@ bool CmdCompare::process( uint32_t frame ) {
 
   // save the result
   if ( _outputModelAFilename != "" ) {
-    if ( !mm::IO::saveModel( _outputModelAFilename, outputModelA ) ) return false;
+    if ( !mm::IO::saveModel( _outputModelAFilename, outputModelA, _binaryPly ) ) return false;
   } else {
     delete outputModelA;
   }
   // save the result
   if ( _outputModelBFilename != "" ) {
-    if ( !mm::IO::saveModel( _outputModelBFilename, outputModelB ) ) return false;
+    if ( !mm::IO::saveModel( _outputModelBFilename, outputModelB, _binaryPly ) ) return false;
   } else {
     delete outputModelB;
   }
@@ -541,6 +514,11 @@ bool CmdCompare::process( uint32_t frame ) {
   return true;
 }
 
+bool CmdCompare::merge( Command* clone ) {
+  _compare.merge( static_cast<CmdCompare*>( clone )->_compare );
+  return true;
+}
+
 bool CmdCompare::finalize() {
   // Collect the statistics
   if ( _mode == "pcc" ) { _compare.pccFinalize(); }
@@ -51,6 +51,8 @@ bool CmdDegrade::initialize( Context* ctx, std::string app, int argc, char* argv
 				cxxopts::value<std::string>())
 			("o,outputModel", "path to output model (obj or ply file)",
 				cxxopts::value<std::string>())
+			("plyFormat", "output format of ply files in [ascii,binary]",
+				cxxopts::value<std::string>()->default_value("ascii"))
 			("mode", "the sampling mode in [delface]",
 				cxxopts::value<std::string>())
 			("nthFace", "in delface mode, remove one face every nthFace.",
@@ -82,6 +84,7 @@ bool CmdDegrade::initialize( Context* ctx, std::string app, int argc, char* argv
       std::cout << options.help() << std::endl;
       return false;
     }
+    if ( !parsePlyFormatOption( result, _binaryPly ) ) return false;
     //
     if ( result.count( "mode" ) ) _mode = result["mode"].as<std::string>();
 
@@ -132,7 +135,7 @@ bool CmdDegrade::process( uint32_t frame ) {
   std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
 
   // save the result
-  if ( mm::IO::saveModel( _outputModelFilename, outputModel ) ) return true;
+  if ( mm::IO::saveModel( _outputModelFilename, outputModel, _binaryPly ) ) return true;
   else return false;
 }
 
@@ -55,6 +55,8 @@ bool CmdDequantize::initialize( Context* ctx, std::string app, int argc, char* a
 				cxxopts::value<std::string>())
 			("o,outputModel", "path to output model (obj or ply file)",
 				cxxopts::value<std::string>())
+			("plyFormat", "output format of ply files in [ascii,binary]",
+				cxxopts::value<std::string>()->default_value("ascii"))
 			("h,help", "Print usage")
 			("qp", "Geometry quantization bitdepth. No dequantization of geometry if not set or < 7.",
 				cxxopts::value<uint32_t>())
@@ -108,6 +110,7 @@ bool CmdDequantize::initialize( Context* ctx, std::string app, int argc, char* a
       std::cout << options.help() << std::endl;
       return false;
     }
+    if ( !parsePlyFormatOption( result, _binaryPly ) ) return false;
     //
     if ( result.count( "qp" ) ) _qp = result["qp"].as<uint32_t>();
     if ( result.count( "qt" ) ) _qt = result["qt"].as<uint32_t>();
@@ -257,7 +260,7 @@ bool CmdDequantize::process( uint32_t frame ) {
   std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
 
   // save the result
-  if ( mm::IO::saveModel( _outputModelFilename, outputModel ) ) return true;
+  if ( mm::IO::saveModel( _outputModelFilename, outputModel, _binaryPly ) ) return true;
   else {
     delete outputModel;
     return false;
@@ -54,6 +54,8 @@ bool CmdNormals::initialize( Context* ctx, std::string app, int argc, char* argv
 				cxxopts::value<std::string>())
 			("o,outputModel", "path to output model (obj or ply file)",
 				cxxopts::value<std::string>())
+			("plyFormat", "output format of ply files in [ascii,binary]",
+				cxxopts::value<std::string>()->default_value("ascii"))
 			("h,help", "Print usage")
 			("normalized", "generated normals are normalized",
 				cxxopts::value<bool>()->default_value("true"))
@@ -83,6 +85,7 @@ bool CmdNormals::initialize( Context* ctx, std::string app, int argc, char* argv
       std::cout << options.help() << std::endl;
       return false;
     }
+    if ( !parsePlyFormatOption( result, _binaryPly ) ) return false;
     //
     if ( result.count( "normalized" ) ) _normalized = result["normalized"].as<bool>();
     if ( result.count( "noSeams" ) ) _noSeams = result["noSeams"].as<bool>();
@@ -124,7 +127,7 @@ bool CmdNormals::process( uint32_t frame ) {
   std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
 
   // save the result
-  if ( mm::IO::saveModel( _outputModelFilename, outputModel ) ) return true;
+  if ( mm::IO::saveModel( _outputModelFilename, outputModel, _binaryPly ) ) return true;
   else {
     delete outputModel;
     return false;
@@ -19,6 +19,7 @@
 #include <iostream>
 #include <algorithm>
 #include <fstream>
+#include <cstdio>
 #include <unordered_map>
 #include <time.h>
 #include <math.h>
@@ -47,6 +48,7 @@ Command* CmdQuantize::create() { return new CmdQuantize(); }
 
 //
 bool CmdQuantize::initialize( Context* ctx, std::string app, int argc, char* argv[] ) {
+  _context = ctx;
   // command line parameters
   try {
     cxxopts::Options options( app + " " + name, brief );
@@ -56,6 +58,8 @@ bool CmdQuantize::initialize( Context* ctx, std::string app, int argc, char* arg
 				cxxopts::value<std::string>())
 			("o,outputModel", "path to output model (obj or ply file)",
 				cxxopts::value<std::string>())
+			("plyFormat", "output format of ply files in [ascii,binary]",
+				cxxopts::value<std::string>()->default_value("ascii"))
 			("h,help", "Print usage")
 			("dequantize", "set to process dequantification at the ouput")
 			("qp", "Geometry quantization bitdepth. A value < 7 means no quantization.",
@@ -112,6 +116,7 @@ bool CmdQuantize::initialize( Context* ctx, std::string app, int argc, char* arg
       std::cout << options.help() << std::endl;
       return false;
     }
+    if ( !parsePlyFormatOption( result, _binaryPly ) ) return false;
 
     if ( result.count( "outputVar" ) ) _outputVarFilename = result["outputVar"].as<std::string>();
 
@@ -211,6 +216,9 @@ bool CmdQuantize::process( uint32_t frame ) {
   // the output
   mm::Model* outputModel = new mm::Model();
 
+  // an intermediate model that no other command reads is moved instead of copied, then quantized in place
+  const bool movable = mm::IO::isMovable( _inputModelFilename );
+
   // Perform the processings
   clock_t t1 = clock();
 
@@ -230,16 +238,27 @@ bool CmdQuantize::process( uint32_t frame ) {
   glm::vec3 minCol = _minCol;
   glm::vec3 maxCol = _maxCol;
 
+  // in frame parallel mode the variables are written in a file per frame, renamed in frame order
+  // so that the output file holds the variables of the last frame as in serial mode
+  std::string outputVarFilename = _outputVarFilename;
+  if ( outputVarFilename != "" && _context->getFrameParallel() > 1 ) {
+    outputVarFilename += "." + std::to_string( frame ) + ".tmp";
+  }
+
   if ( _dequantize ) {
     mm::Model* quantizedModel = new mm::Model();
 
-    mm::Quantize::quantize( *inputModel,
-                            *quantizedModel,
+    if ( movable ) {
+      *quantizedModel = std::move( *inputModel );
+    } else {
+      *quantizedModel = *inputModel;
+    }
+    mm::Quantize::quantize( *quantizedModel,
                             _qp,
                             _qt,
                             _qn,
                             _qc,
-                            _outputVarFilename,
+                            outputVarFilename,
                             _useFixedPoint,
                             _colorSpaceConversion,
                             minPos,
@@ -272,13 +291,17 @@ bool CmdQuantize::process( uint32_t frame ) {
     delete quantizedModel;
   } else {
     // uses min/max potentially updated by previous frame call to quantize
-    mm::Quantize::quantize( *inputModel,
-                            *outputModel,
+    if ( movable ) {
+      *outputModel = std::move( *inputModel );
+    } else {
+      *outputModel = *inputModel;
+    }
+    mm::Quantize::quantize( *outputModel,
                             _qp,
                             _qt,
                             _qn,
                             _qc,
-                            _outputVarFilename,
+                            outputVarFilename,
                             _useFixedPoint,
                             _colorSpaceConversion,
                             minPos,
@@ -291,11 +314,19 @@ bool CmdQuantize::process( uint32_t frame ) {
                             maxCol );
   }
 
+  if ( outputVarFilename != _outputVarFilename ) {
+    const std::string filename = _outputVarFilename;
+    _context->commit( frame, [=]() {
+      std::remove( filename.c_str() );
+      std::rename( outputVarFilename.c_str(), filename.c_str() );
+    } );
+  }
+
   clock_t t2 = clock();
   std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
 
   // save the result
-  if ( mm::IO::saveModel( _outputModelFilename, outputModel ) ) return true;
+  if ( mm::IO::saveModel( _outputModelFilename, outputModel, _binaryPly ) ) return true;
   else {
     delete outputModel;
     return false;
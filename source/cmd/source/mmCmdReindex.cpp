@@ -51,6 +51,7 @@ bool CmdReindex::initialize( Context* ctx, std::string app, int argc, char* argv
 		options.add_options()
 			("i,inputModel",  "path to input model (obj or ply file)", cxxopts::value<std::string>() )
 			("o,outputModel", "path to output model (obj or ply file)", cxxopts::value<std::string>())
+			("plyFormat", "output format of ply files in [ascii,binary]", cxxopts::value<std::string>()->default_value("ascii"))
 			("h,help", "Print usage")
 			("sort", "Sort method in none, vertices, oriented, unoriented.", cxxopts::value<std::string>()->default_value("none"))
 				;
@@ -77,6 +78,7 @@ bool CmdReindex::initialize( Context* ctx, std::string app, int argc, char* argv
       std::cout << options.help() << std::endl;
       return false;
     }
+    if ( !parsePlyFormatOption( result, _binaryPly ) ) return false;
     //
     if ( result.count( "sort" ) ) _sort = result["sort"].as<std::string>();
   } catch ( const cxxopts::OptionException& e ) {
@@ -118,7 +120,7 @@ bool CmdReindex::process( uint32_t frame ) {
   std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
 
   // save the result
-  if ( mm::IO::saveModel( _outputModelFilename, outputModel ) ) return true;
+  if ( mm::IO::saveModel( _outputModelFilename, outputModel, _binaryPly ) ) return true;
   else {
     delete outputModel;
     return false;
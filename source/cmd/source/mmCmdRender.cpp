@@ -184,6 +184,12 @@ bool CmdRender::initialize( Context* ctx, std::string app, int argc, char* argv[
     return false;
   }
 
+  // the OpenGL context is bound to the thread that creates it, frame lanes can't share it
+  if ( renderer == "gl12_raster" && ctx->getFrameParallel() > 1 ) {
+    std::cerr << "Error: the gl12_raster renderer requires frameParallel = 1" << std::endl;
+    return false;
+  }
+
   // now initialize OpenGL contexts if needed
   // this part is valid for all the frames
   if ( renderer == "gl12_raster" ) {
@@ -28,6 +28,9 @@
 #include <glm/gtx/string_cast.hpp>
 // argument parsing
 #include <cxxopts.hpp>
+#ifdef OPENMP_FOUND
+#  include <omp.h>
+#endif
 
 // internal headers
 #include "mmGeometry.h"
@@ -59,12 +62,16 @@ bool CmdSample::initialize( Context* context, std::string app, int argc, char* a
 				cxxopts::value<std::string>())
 			("o,outputModel", "path to output model (obj or ply file)",
 				cxxopts::value<std::string>())
+			("plyFormat", "output format of ply files in [ascii,binary]",
+				cxxopts::value<std::string>()->default_value("ascii"))
 			("mode", "the sampling mode in [face,grid,map,sdiv,ediv,prnd]",
 				cxxopts::value<std::string>())
 			("hideProgress", "hide progress display in console for use by robot",
 				cxxopts::value<bool>()->default_value("false"))
 			("outputCsv", "filename of the file where per frame statistics will append.",
 				cxxopts::value<std::string>()->default_value(""))
+			("threads", "number of threads used by the face, grid, sdiv, ediv and prnd modes, 0 for all the available cores.",
+				cxxopts::value<int>()->default_value("0"))
 			("h,help", "Print usage")
 			;
 		options.add_options("face mode")
@@ -94,6 +101,8 @@ bool CmdSample::initialize( Context* context, std::string app, int argc, char* a
 				cxxopts::value<std::string>())
 			("useFixedPoint", "interprets minPos and maxPos inputs as fixed point 16.",
 				cxxopts::value<bool>())
+			("gridMethod", "method to find the grid cells covered by the triangles in [ray,raster].",
+				cxxopts::value<std::string>()->default_value("ray"))
 			;
 		options.add_options("prnd mode")
 			("nbSamples", "integer value specifying the traget number of points in the output point cloud",
@@ -113,6 +122,8 @@ bool CmdSample::initialize( Context* context, std::string app, int argc, char* a
 				cxxopts::value<size_t>()->default_value("0"))
 			("maxIterations", "Maximum number of iterations in sample count constrained sampling, i.e. when --nbSampleMin > 0.",
 				cxxopts::value<size_t>()->default_value("10"))
+			("countOnly", "if set, the points are only counted and the count is written to the csv. No model is saved. The colors are only fetched from the map to tell apart the points of texture seams.",
+				cxxopts::value<bool>()->default_value("false"))
 			;
     // clang-format on
 
@@ -139,6 +150,7 @@ bool CmdSample::initialize( Context* context, std::string app, int argc, char* a
       std::cout << options.help() << std::endl;
       return false;
     }
+    if ( !parsePlyFormatOption( result, _binaryPly ) ) return false;
 
     //
     if ( result.count( "mode" ) ) mode = result["mode"].as<std::string>();
@@ -154,6 +166,12 @@ bool CmdSample::initialize( Context* context, std::string app, int argc, char* a
     //
     if ( result.count( "hideProgress" ) ) hideProgress = result["hideProgress"].as<bool>();
     //
+    if ( result.count( "threads" ) ) _threads = result["threads"].as<int>();
+    if ( _threads < 0 ) {
+      std::cerr << "Error: invalid threads " << _threads << std::endl;
+      return false;
+    }
+    //
     if ( result.count( "resolution" ) ) _resolution = result["resolution"].as<size_t>();
     if ( result.count( "thickness" ) ) thickness = result["thickness"].as<float>();
     if ( result.count( "areaThreshold" ) ) areaThreshold = result["areaThreshold"].as<float>();
@@ -171,6 +189,15 @@ bool CmdSample::initialize( Context* context, std::string app, int argc, char* a
       }
     }
     if ( result.count( "maxIterations" ) ) _maxIterations = result["maxIterations"].as<size_t>();
+    if ( result.count( "countOnly" ) ) _countOnly = result["countOnly"].as<bool>();
+    if ( _countOnly && ( mode == "map" || mode == "prnd" ) ) {
+      std::cerr << "Error: countOnly is not available in " << mode << " mode" << std::endl;
+      return false;
+    }
+    if ( _countOnly && _nbSamplesMin != 0 ) {
+      std::cerr << "Error: countOnly cannot be used with nbSamplesMin" << std::endl;
+      return false;
+    }
 
     // prnd options
     if ( result.count( "nbSamples" ) ) _nbSamples = result["nbSamples"].as<size_t>();
@@ -193,6 +220,11 @@ bool CmdSample::initialize( Context* context, std::string app, int argc, char* a
       }
     }
     if ( result.count( "useFixedPoint" ) ) { _useFixedPoint = result["useFixedPoint"].as<bool>(); }
+    if ( result.count( "gridMethod" ) ) _gridMethod = result["gridMethod"].as<std::string>();
+    if ( _gridMethod != "ray" && _gridMethod != "raster" ) {
+      std::cerr << "Error: invalid gridMethod \"" << _gridMethod << "\"" << std::endl;
+      return false;
+    }
 
   } catch ( const cxxopts::OptionException& e ) {
     std::cout << "error parsing options: " << e.what() << std::endl;
@@ -223,23 +255,11 @@ bool CmdSample::process( uint32_t frame ) {
   // the output
   mm::Model* outputModel = new mm::Model();
 
-  // create or open in append mode output csv if needed
-  std::streamoff csvFileLength = 0;
-  std::ofstream  csvFileOut;
-  if ( _outputCsvFilename != "" ) {
-    // check if csv file is empty, need to open in read mode
-    std::ifstream filestr;
-    filestr.open( _outputCsvFilename, std::ios::binary );
-    if ( filestr ) {
-      filestr.seekg( 0, std::ios::end );
-      csvFileLength = filestr.tellg();
-      filestr.close();
-    }
-    // let's open in append write mode
-    csvFileOut.open( _outputCsvFilename.c_str(), std::ios::out | std::ofstream::app );
-    // this is mandatory to print floats with full precision
-    csvFileOut.precision( std::numeric_limits<float>::max_digits10 );
-  }
+#ifdef OPENMP_FOUND
+  // the default thread count is restored after the sampling so that other commands are not affected
+  const int defaultThreads = omp_get_max_threads();
+  if ( _threads > 0 ) omp_set_num_threads( _threads );
+#endif
 
   // Perform the processings
   clock_t t1 = clock();
@@ -253,6 +273,7 @@ bool CmdSample::process( uint32_t frame ) {
     std::cout << "  nbSamplesMax = " << _nbSamplesMax << std::endl;
     std::cout << "  maxIterations = " << _maxIterations << std::endl;
     size_t computedResolution = 0;
+    size_t nbSamples          = 0;
     if ( _nbSamplesMin != 0 ) {
       std::cout << "  using contrained mode with nbSamples (costly!)" << std::endl;
       mm::Sample::meshToPcFace( *inputModel,
@@ -265,35 +286,35 @@ bool CmdSample::process( uint32_t frame ) {
                                 bilinear,
                                 !hideProgress,
                                 computedResolution );
+      nbSamples = outputModel->getPositionCount();
     } else {
       std::cout << "  using contrained mode with resolution " << std::endl;
-      mm::Sample::meshToPcFace(
-        *inputModel, *outputModel, *textureMap, _resolution, thickness, bilinear, !hideProgress );
+      nbSamples = mm::Sample::meshToPcFace(
+        *inputModel, *outputModel, *textureMap, _resolution, thickness, bilinear, !hideProgress, _countOnly );
     }
     // print the stats
-    if ( csvFileOut ) {
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "model;texture;frame;resolution;thickness;bilinear;nbSamplesMin;"
-                   << "nbSamplesMax;maxIterations;computedResolution;nbSamples" << std::endl;
-      }
-      // print stats
-      csvFileOut << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << _resolution << ";"
-                 << thickness << ";" << bilinear << ";" << _nbSamplesMin << ";" << _nbSamplesMax << ";"
-                 << _maxIterations << ";" << computedResolution << ";" << outputModel->getPositionCount() << std::endl;
-      // done
-      csvFileOut.close();
+    if ( _outputCsvFilename != "" ) {
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "model;texture;frame;resolution;thickness;bilinear;nbSamplesMin;"
+             << "nbSamplesMax;maxIterations;computedResolution;nbSamples";
+      row << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << _resolution << ";"
+          << thickness << ";" << bilinear << ";" << _nbSamplesMin << ";" << _nbSamplesMax << ";"
+          << _maxIterations << ";" << computedResolution << ";" << nbSamples;
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else if ( mode == "grid" ) {
     std::cout << "Sampling in GRID mode" << std::endl;
     std::cout << "  Grid Size = " << _gridSize << std::endl;
     std::cout << "  Use Normal = " << _useNormal << std::endl;
+    std::cout << "  Grid Method = " << _gridMethod << std::endl;
     std::cout << "  Bilinear = " << bilinear << std::endl;
     std::cout << "  hideProgress = " << hideProgress << std::endl;
     std::cout << "  nbSamplesMin = " << _nbSamplesMin << std::endl;
     std::cout << "  nbSamplesMax = " << _nbSamplesMax << std::endl;
     std::cout << "  maxIterations = " << _maxIterations << std::endl;
     size_t computedResolution = 0;
+    size_t nbSamples          = 0;
     if ( _nbSamplesMin != 0 ) {
       std::cout << "  using contrained mode with nbSamples (costly!)" << std::endl;
       mm::Sample::meshToPcGrid( *inputModel,
@@ -306,49 +327,50 @@ bool CmdSample::process( uint32_t frame ) {
                                 !hideProgress,
                                 _useNormal,
                                 _useFixedPoint,
+                                _gridMethod == "raster",
                                 _minPos,
                                 _maxPos,
                                 computedResolution );
+      nbSamples = outputModel->getPositionCount();
     } else {
       std::cout << "  using contrained mode with gridSize " << std::endl;
-      mm::Sample::meshToPcGrid( *inputModel,
-                                *outputModel,
-                                *textureMap,
-                                _gridSize,
-                                bilinear,
-                                !hideProgress,
-                                _useNormal,
-                                _useFixedPoint,
-                                _minPos,
-                                _maxPos );
+      nbSamples = mm::Sample::meshToPcGrid( *inputModel,
+                                            *outputModel,
+                                            *textureMap,
+                                            _gridSize,
+                                            bilinear,
+                                            !hideProgress,
+                                            _useNormal,
+                                            _useFixedPoint,
+                                            _gridMethod == "raster",
+                                            _minPos,
+                                            _maxPos,
+                                            true,
+                                            _countOnly );
     }
     // print the stats
-    if ( csvFileOut ) {
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "model;texture;frame;mode;gridSize;useNormal;bilinear;nbSamplesMin;"
-                   << "nbSamplesMax;maxIterations;computedResolution;nbSamples" << std::endl;
-      }
-      // print stats
-      csvFileOut << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";" << _gridSize
-                 << ";" << _useNormal << ";" << bilinear << ";" << _nbSamplesMin << ";" << _nbSamplesMax << ";"
-                 << _maxIterations << ";" << computedResolution << ";" << outputModel->getPositionCount() << std::endl;
-      // done
-      csvFileOut.close();
+    if ( _outputCsvFilename != "" ) {
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "model;texture;frame;mode;gridSize;useNormal;bilinear;nbSamplesMin;"
+             << "nbSamplesMax;maxIterations;computedResolution;nbSamples";
+      row << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";" << _gridSize
+          << ";" << _useNormal << ";" << bilinear << ";" << _nbSamplesMin << ";" << _nbSamplesMax << ";"
+          << _maxIterations << ";" << computedResolution << ";" << nbSamples;
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else if ( mode == "map" ) {
     std::cout << "Sampling in MAP mode" << std::endl;
     std::cout << "  hideProgress = " << hideProgress << std::endl;
     mm::Sample::meshToPcMap( *inputModel, *outputModel, *textureMap, !hideProgress );
     // print the stats
-    if ( csvFileOut ) {
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) { csvFileOut << "model;texture;frame;mode;nbSamples" << std::endl; }
-      // print stats
-      csvFileOut << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";"
-                 << outputModel->getPositionCount() << std::endl;
-      // done
-      csvFileOut.close();
+    if ( _outputCsvFilename != "" ) {
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "model;texture;frame;mode;nbSamples";
+      row << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";"
+          << outputModel->getPositionCount();
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else if ( mode == "sdiv" ) {
     std::cout << "Sampling in SDIV mode" << std::endl;
@@ -359,7 +381,8 @@ bool CmdSample::process( uint32_t frame ) {
     std::cout << "  nbSamplesMin = " << _nbSamplesMin << std::endl;
     std::cout << "  nbSamplesMax = " << _nbSamplesMax << std::endl;
     std::cout << "  maxIterations = " << _maxIterations << std::endl;
-    float computedThres = 0.0f;
+    float  computedThres = 0.0f;
+    size_t nbSamples     = 0;
     if ( _nbSamplesMin != 0 ) {
       std::cout << "  using contrained mode with nbSamples (costly!)" << std::endl;
       mm::Sample::meshToPcDiv( *inputModel,
@@ -371,23 +394,21 @@ bool CmdSample::process( uint32_t frame ) {
                                bilinear,
                                !hideProgress,
                                computedThres );
+      nbSamples = outputModel->getPositionCount();
     } else {
-      mm::Sample::meshToPcDiv(
-        *inputModel, *outputModel, *textureMap, areaThreshold, mapThreshold, bilinear, !hideProgress );
+      nbSamples = mm::Sample::meshToPcDiv(
+        *inputModel, *outputModel, *textureMap, areaThreshold, mapThreshold, bilinear, !hideProgress, _countOnly );
     }
     // print the stats
-    if ( csvFileOut ) {
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "model;texture;frame;mode;areaThreshold;bilinear;nbSamplesMin;"
-                   << "nbSamplesMax;maxIterations;computedThreshold;nbSamples" << std::endl;
-      }
-      // print stats
-      csvFileOut << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";"
-                 << areaThreshold << ";" << bilinear << ";" << _nbSamplesMin << ";" << _nbSamplesMax << ";"
-                 << _maxIterations << ";" << computedThres << ";" << outputModel->getPositionCount() << std::endl;
-      // done
-      csvFileOut.close();
+    if ( _outputCsvFilename != "" ) {
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "model;texture;frame;mode;areaThreshold;bilinear;nbSamplesMin;"
+             << "nbSamplesMax;maxIterations;computedThreshold;nbSamples";
+      row << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";"
+          << areaThreshold << ";" << bilinear << ";" << _nbSamplesMin << ";" << _nbSamplesMax << ";"
+          << _maxIterations << ";" << computedThres << ";" << nbSamples;
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else if ( mode == "ediv" ) {
     std::cout << "Sampling in EDIV mode" << std::endl;
@@ -398,7 +419,8 @@ bool CmdSample::process( uint32_t frame ) {
     std::cout << "  nbSamplesMin = " << _nbSamplesMin << std::endl;
     std::cout << "  nbSamplesMax = " << _nbSamplesMax << std::endl;
     std::cout << "  maxIterations = " << _maxIterations << std::endl;
-    float computedThres = 0.0f;
+    float  computedThres = 0.0f;
+    size_t nbSamples     = 0;
     if ( _nbSamplesMin != 0 ) {
       std::cout << "  using contrained mode with nbSamples (costly!)" << std::endl;
       mm::Sample::meshToPcDivEdge( *inputModel,
@@ -410,24 +432,28 @@ bool CmdSample::process( uint32_t frame ) {
                                    bilinear,
                                    !hideProgress,
                                    computedThres );
+      nbSamples = outputModel->getPositionCount();
     } else {
-      mm::Sample::meshToPcDivEdge(
-        *inputModel, *outputModel, *textureMap, lengthThreshold, _resolution, bilinear, !hideProgress, computedThres );
+      nbSamples = mm::Sample::meshToPcDivEdge( *inputModel,
+                                               *outputModel,
+                                               *textureMap,
+                                               lengthThreshold,
+                                               _resolution,
+                                               bilinear,
+                                               !hideProgress,
+                                               computedThres,
+                                               _countOnly );
     }
     // print the stats
-    if ( csvFileOut ) {
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "model;texture;frame;mode;resolution;lengthThreshold;bilinear;nbSamplesMin;"
-                   << "nbSamplesMax;maxIterations;computedThreshold;nbSamples" << std::endl;
-      }
-      // print stats
-      csvFileOut << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";"
-                 << _resolution << ";" << lengthThreshold << ";" << bilinear << ";" << _nbSamplesMin << ";"
-                 << _nbSamplesMax << ";" << _maxIterations << ";" << computedThres << ";"
-                 << outputModel->getPositionCount() << std::endl;
-      // done
-      csvFileOut.close();
+    if ( _outputCsvFilename != "" ) {
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "model;texture;frame;mode;resolution;lengthThreshold;bilinear;nbSamplesMin;"
+             << "nbSamplesMax;maxIterations;computedThreshold;nbSamples";
+      row << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";"
+          << _resolution << ";" << lengthThreshold << ";" << bilinear << ";" << _nbSamplesMin << ";"
+          << _nbSamplesMax << ";" << _maxIterations << ";" << computedThres << ";" << nbSamples;
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   } else if ( mode == "prnd" ) {
     std::cout << "Sampling in PRND mode" << std::endl;
@@ -436,22 +462,28 @@ bool CmdSample::process( uint32_t frame ) {
     std::cout << "  hideProgress = " << hideProgress << std::endl;
     mm::Sample::meshToPcPrnd( *inputModel, *outputModel, *textureMap, _nbSamples, bilinear, !hideProgress );
     // print the stats
-    if ( csvFileOut ) {
-      // print the header if file is empty
-      if ( csvFileLength == 0 ) {
-        csvFileOut << "model;texture;frame;mode;targetPointCount;bilinear;nbSamples" << std::endl;
-      }
-      // print stats
-      csvFileOut << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";"
-                 << _nbSamples << ";" << bilinear << ";" << outputModel->getPositionCount() << std::endl;
-      // done
-      csvFileOut.close();
+    if ( _outputCsvFilename != "" ) {
+      std::ostringstream header, row;
+      row.precision( std::numeric_limits<float>::max_digits10 );
+      header << "model;texture;frame;mode;targetPointCount;bilinear;nbSamples";
+      row << inputModelFilename << ";" << inputTextureFilename << ";" << frame << ";" << mode << ";"
+          << _nbSamples << ";" << bilinear << ";" << outputModel->getPositionCount();
+      commitCsvRow( _context, frame, _outputCsvFilename, header.str(), row.str() );
     }
   }
   clock_t t2 = clock();
   std::cout << "Time on processing: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
 
+#ifdef OPENMP_FOUND
+  omp_set_num_threads( defaultThreads );
+#endif
+
   // save the result
-  if ( mm::IO::saveModel( outputModelFilename, outputModel ) ) return true;
+  if ( _countOnly ) {
+    std::cout << "Skipping model save, points are only counted" << std::endl;
+    delete outputModel;
+    return true;
+  }
+  if ( mm::IO::saveModel( outputModelFilename, outputModel, _binaryPly ) ) return true;
   else return false;
 }
@@ -46,6 +46,14 @@ bool CmdSequence::initialize( Context* ctx, std::string app, int argc, char* arg
 				cxxopts::value<int>()->default_value("0"))
 			("lastFrame", "Sets the last frame of the sequence, included. Must be >= to firstFrame.",
 				cxxopts::value<int>()->default_value("0"))
+			("prefetch", "Number of next frames whose input models and images are loaded in background "
+			 "while processing the current frame. 0 to disable.",
+				cxxopts::value<int>()->default_value("0"))
+			("prefetchMem", "Maximum size in MB of the input files being prefetched.",
+				cxxopts::value<int>()->default_value("1024"))
+			("frameParallel", "Number of frames processed concurrently. Prefetch is disabled if > 1. "
+			 "The gl12_raster renderer requires 1.",
+				cxxopts::value<int>()->default_value("1"))
 			("h,help", "Print usage")
 			;
     // clang-format on
@@ -68,6 +76,24 @@ bool CmdSequence::initialize( Context* ctx, std::string app, int argc, char* arg
       return false;
     }
     ctx->setFrameRange( firstFrame, lastFrame );
+    //
+    int prefetch    = 0;
+    int prefetchMem = 1024;
+    if ( result.count( "prefetch" ) ) prefetch = result["prefetch"].as<int>();
+    if ( result.count( "prefetchMem" ) ) prefetchMem = result["prefetchMem"].as<int>();
+    if ( prefetch < 0 || prefetchMem < 0 ) {
+      std::cerr << "Error: prefetch and prefetchMem must be >= 0" << std::endl;
+      return false;
+    }
+    ctx->setPrefetch( (uint32_t)prefetch, (size_t)prefetchMem * 1024 * 1024 );
+    //
+    int frameParallel = 1;
+    if ( result.count( "frameParallel" ) ) frameParallel = result["frameParallel"].as<int>();
+    if ( frameParallel < 1 ) {
+      std::cerr << "Error: frameParallel must be >= 1. Got frameParallel=" << frameParallel << std::endl;
+      return false;
+    }
+    ctx->setFrameParallel( (uint32_t)frameParallel );
   } catch ( const cxxopts::OptionException& e ) {
     std::cout << "Error: parsing options, " << e.what() << std::endl;
     return false;
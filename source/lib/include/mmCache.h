@@ -0,0 +1,59 @@
+// ************* COPYRIGHT AND CONFIDENTIALITY INFORMATION *********
+// Copyright 2021 - InterDigital
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+// Author: jean-eudes.marvie@interdigital.com
+// *****************************************************************
+
+#ifndef _MM_CACHE_H_
+#define _MM_CACHE_H_
+
+#include <string>
+
+#include "mmModel.h"
+
+namespace mm {
+
+// Persistent on-disk cache of parsed models, shared among mm processes.
+// Disabled by default, enabled by setting the MM_CACHE_DIR environment variable
+// to the cache folder. MM_CACHE_SIZE sets the size limit of the folder in MB
+// (default 4096), least recently used snapshots are removed beyond this limit.
+// Snapshots are mmb files named after a hash of the absolute path, size and
+// modification time of the source file and of IO::LOADER_VERSION, so edited files
+// are never served stale, nor files parsed by an older version of the loaders.
+class Cache {
+  Cache() {}
+
+ public:
+  // return true if the cache is enabled
+  static bool enabled( void );
+
+  // fills output and returns true if a snapshot of filename is in the cache
+  static bool load( const std::string& filename, Model& output );
+
+  // stores a snapshot of model, the result of parsing filename.
+  // safe for concurrent use, the snapshot is written in a temporary file then renamed.
+  static void store( const std::string& filename, const Model& model );
+
+ private:
+  // returns the snapshot path for filename, empty string if source file cannot be accessed
+  static std::string snapshotPath( const std::string& filename );
+
+  // removes the least recently used snapshots to fit in the size limit
+  static void evict( void );
+};
+
+}  // namespace mm
+
+#endif
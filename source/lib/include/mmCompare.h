@@ -51,6 +51,8 @@ class Compare {
   std::vector<std::tuple<uint32_t, double, double> > _pcqmResults;
   // Raster results array of <frame, result>
   std::vector<std::pair<uint32_t, IbsmResults> > _ibsmResults;
+  // index in the sequence of the frame being compared, labels the results
+  uint32_t _frameIndex;
 
   // Renderers for the ibsm metric
   mm::RendererSw _swRenderer;             // the Software renderer
@@ -66,6 +68,13 @@ class Compare {
     return (std::max)(_pccResults.size(),
                       (std::max)(_pcqmResults.size(), _pcqmResults.size()));
   }
+  // sets the index in the sequence of the frame being compared by next calls
+  void setFrameIndex( uint32_t index ) { _frameIndex = index; }
+
+  // appends the results of a comparator that processed other frames of the sequence,
+  // results are then sorted by frame index
+  void merge( const Compare& other );
+
   std::vector<double> getFinalPccResults();
   std::vector<double> getFinalPcqmResults();
   std::vector<double> getFinalIbsmResults();
@@ -104,21 +113,25 @@ class Compare {
             const std::string& vertexMapFilenane = "" );
 
   // compare two meshes using MPEG pcc_distortion metric
-  int pcc( const mm::Model&         modelA,
-           const mm::Model&         modelB,
+  // if movableA (resp. movableB) is true, modelA (resp. modelB) is consumed to spare a copy and left unspecified
+  int pcc( mm::Model&               modelA,
+           mm::Model&               modelB,
            const mm::Image&         mapA,
            const mm::Image&         mapB,
            pcc_quality::commandPar& params,
            mm::Model&               outputA,
            mm::Model&               outputB,
-           const bool               verbose = true);
+           const bool               verbose  = true,
+           const bool               movableA = false,
+           const bool               movableB = false );
 
   // collect statics over sequence and compute results
   void pccFinalize( void );
 
   // compare two meshes using PCQM metric
-  int pcqm( const mm::Model& modelA,
-            const mm::Model& modelB,
+  // if movableA (resp. movableB) is true, modelA (resp. modelB) is consumed to spare a copy and left unspecified
+  int pcqm( mm::Model&       modelA,
+            mm::Model&       modelB,
             const mm::Image& mapA,
             const mm::Image& mapB,
             const double     radiusCurvature,
@@ -126,7 +139,9 @@ class Compare {
             const double     radiusFactor,
             mm::Model&       outputA,
             mm::Model&       outputB,
-            const bool       verbose = true );
+            const bool       verbose  = true,
+            const bool       movableA = false,
+            const bool       movableB = false );
 
   // collect statics over sequence and compute results
   void pcqmFinalize( void );
@@ -22,11 +22,18 @@
 #include <string>
 #include <map>
 #include <iostream>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <vector>
 
 class Context {
  public:
-  Context() : _frame( 0 ), _firstFrame( 0 ), _lastFrame( 0 ) {}
+  Context()
+    : _firstFrame( 0 ), _lastFrame( 0 ), _prefetchDepth( 0 ), _prefetchMemory( 0 ), _frameParallel( 1 ),
+      _nextCommitFrame( 0 ) {}
 
+  // the current frame is per thread, so that frames can be processed concurrently
   bool setFrame( uint32_t frame ) {
     if ( frame < _firstFrame || frame > _lastFrame ) { return false; }
     _frame = frame;
@@ -37,8 +44,9 @@ class Context {
   // first and last frame are included
   bool setFrameRange( uint32_t first, uint32_t last ) {
     if ( first > last ) return false;
-    _firstFrame = first;
-    _lastFrame  = last;
+    _firstFrame      = first;
+    _lastFrame       = last;
+    _nextCommitFrame = first;
     return true;
   }
 
@@ -46,10 +54,61 @@ class Context {
   uint32_t getLastFrame( void ) { return _lastFrame; }
   uint32_t getFrameCount( void ) { return _lastFrame - _firstFrame + 1; }
 
+  // number of next frames whose inputs are loaded in background, 0 to disable
+  // and memory limit in bytes of the files being prefetched
+  void setPrefetch( uint32_t depth, size_t memory ) {
+    _prefetchDepth  = depth;
+    _prefetchMemory = memory;
+  }
+  uint32_t getPrefetchDepth( void ) { return _prefetchDepth; }
+  size_t   getPrefetchMemory( void ) { return _prefetchMemory; }
+
+  // number of frames processed concurrently
+  void     setFrameParallel( uint32_t count ) { _frameParallel = count < 1 ? 1 : count; }
+  uint32_t getFrameParallel( void ) { return _frameParallel; }
+
+  // outputs shared among the frames, such as csv rows, are written through commit so that
+  // they happen in frame order whatever the frame parallelism. func is invoked immediately
+  // if all the previous frames are done, it is deferred until they are otherwise.
+  // func must not reference data local to the processing of the frame.
+  void commit( uint32_t frame, std::function<void( void )> func ) {
+    std::unique_lock<std::mutex> lock( _commitMutex );
+    if ( frame == _nextCommitFrame ) {
+      lock.unlock();
+      func();
+    } else {
+      _pendingCommits[frame].push_back( func );
+    }
+  }
+
+  // to be invoked when all the commands are processed for the frame, runs the deferred commits
+  // of the next frames in order. frames shall be set done in increasing order of completion.
+  void setFrameDone( uint32_t frame ) {
+    std::lock_guard<std::mutex> lock( _commitMutex );
+    _doneFrames.insert( frame );
+    while ( _doneFrames.count( _nextCommitFrame ) ) {
+      _doneFrames.erase( _nextCommitFrame );
+      ++_nextCommitFrame;
+      auto it = _pendingCommits.find( _nextCommitFrame );
+      if ( it != _pendingCommits.end() ) {
+        for ( auto& func : it->second ) func();
+        _pendingCommits.erase( it );
+      }
+    }
+  }
+
  private:
-  uint32_t _frame;  // current frame
-  uint32_t _firstFrame;
-  uint32_t _lastFrame;
+  static inline thread_local uint32_t _frame = 0;  // current frame
+  uint32_t                            _firstFrame;
+  uint32_t                            _lastFrame;
+  uint32_t                            _prefetchDepth;
+  size_t                              _prefetchMemory;
+  uint32_t                            _frameParallel;
+  // ordered commits
+  std::mutex                                                   _commitMutex;
+  uint32_t                                                     _nextCommitFrame;  // first frame not done
+  std::set<uint32_t>                                           _doneFrames;
+  std::map<uint32_t, std::vector<std::function<void( void )>>> _pendingCommits;
 };
 
 #endif
@@ -22,6 +22,7 @@
 //
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 #include "glm/glm.hpp"
 
 namespace mm {
@@ -181,6 +182,74 @@ class Geometry {
                                glm::vec3&       res,
                                float            epsilon = ZERO_TOLERANCE );
 
+  // instruction sets that can be used by the batch functions
+  enum SimdLevel { SIMD_SCALAR = 0, SIMD_SSE2 = 1, SIMD_AVX2 = 2 };
+
+  // returns the instruction set used by the batch functions, the best one supported by the cpu by default
+  static SimdLevel getSimdLevel();
+
+  // forces the instruction set used by the batch functions, levels not supported by the cpu are lowered
+  // to the best supported one. not thread safe, meant for benchmarking.
+  static void setSimdLevel( SimdLevel level );
+
+  // intersects count rays sharing the same direction with the triangle (v0,v1,v2), the terms
+  // depending only on the direction and the triangle are computed once for all the rays.
+  // ray i starts from (originX[i],originY[i],originZ[i]), hits[i] is set to 1 if it intersects the triangle
+  // and then t[i], u[i], v[i] are set as res by evalRayTriangle, the results are bit exact with it.
+  // rays are processed by packets of 8 or 4 using AVX2 or SSE2 if available.
+  // return the number of hits
+  static size_t evalRayTriangleBatch( const glm::vec3& rayDirection,
+                                      const size_t     count,
+                                      const float*     originX,
+                                      const float*     originY,
+                                      const float*     originZ,
+                                      const glm::vec3& v0,
+                                      const glm::vec3& v1,
+                                      const glm::vec3& v2,
+                                      float*           t,
+                                      float*           u,
+                                      float*           v,
+                                      uint8_t*         hits,
+                                      float            epsilon = ZERO_TOLERANCE );
+
+  // computes the normals of count triangles, normal i is glm::cross( p1 - p0, p2 - p0 ), not normalized,
+  // with pj the position of index triangles[i * 3 + j]. positions and normals are xyz triples.
+  // the results are bit exact with glm::cross.
+  static void computeFaceNormalsBatch( const size_t count,
+                                       const float* positions,
+                                       const int*   triangles,
+                                       float*       normals );
+
+  // normalizes count xyz triples in place as glm::normalize, the vectors that cannot be normalized
+  // (nan x after normalization) are set to (0, 0, 1). vectors are processed by packets of 8 or 4
+  // using AVX2 or SSE2 if available, the results are bit exact with glm::normalize.
+  static void normalizeBatch( const size_t count, float* vectors );
+
+  // same as computeBBox on count points stored as structure of arrays, point i is (x[i],y[i],z[i]).
+  // points are processed by packets of 8 or 4 using AVX2 or SSE2 if available, with aligned loads
+  // if the arrays are aligned as the ones of Vec3Soa. the results are bit exact with computeBBox.
+  static void computeBBox( const size_t count,
+                           const float* x,
+                           const float* y,
+                           const float* z,
+                           glm::vec3&   minPos,
+                           glm::vec3&   maxPos,
+                           bool         reset = true );
+
+  // quantizes count values of a component in place as the positions in Quantize::quantize,
+  // values[i] = floor( double( values[i] - minValue ) / scale + 0.5 ).
+  // packets as for computeBBox, the results are bit exact with the scalar expression.
+  static void quantizeBatch( const size_t count, float* values, const float minValue, const double scale );
+
+  // quantizes count values of a component in place as the normals and colors in Quantize::quantize,
+  // values[i] = floor( ( values[i] - minValue ) / range * maxValue + 0.5F ).
+  // packets as for computeBBox, the results are bit exact with the scalar expression.
+  static void quantizeBatch( const size_t count,
+                             float*       values,
+                             const float  minValue,
+                             const float  range,
+                             const float  maxValue );
+
   // https://github.com/autonomousvision/occupancy_flow/blob/master/im2mesh/utils/libvoxelize/tribox2.h
   /********************************************************/
   /* AABB-triangle overlap test code                      */
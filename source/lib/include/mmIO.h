@@ -20,7 +20,11 @@
 #define _MM_IO_H_
 
 #include <map>
+#include <ostream>
 #include <string>
+#include <vector>
+#include <future>
+#include <memory>
 
 #include "mmModel.h"
 #include "mmImage.h"
@@ -44,7 +48,8 @@ class IO {
   // return NULL in case of error
   static Model* loadModel( std::string templateName );
 
-  static bool saveModel( std::string templateName, Model* model );
+  // ply files are written in binary_little_endian format if binaryPly is true, ascii otherwise
+  static bool saveModel( std::string templateName, Model* model, bool binaryPly = false );
 
   // load image files and images from videos
   // name can be filename or "ID:xxxx"
@@ -54,22 +59,80 @@ class IO {
   /*
   static bool saveImage(std::string name, Image* image);*/
 
-  // free all the models and images, and reset cache.
+  // sets the pending uses of the models and images of the current frame. each template name is one
+  // read by a command of the pipeline, a name listed twice has two pending uses.
+  static void setUses( const std::vector<std::string>& inputTemplates );
+
+  // to be invoked when a command is done with a frame, with the templates of its inputs and outputs.
+  // one use of each input is consumed, then the inputs and outputs that no other command of the frame
+  // will read are released from the store of the calling thread.
+  static void release( const std::vector<std::string>& inputTemplates,
+                       const std::vector<std::string>& outputTemplates );
+
+  // returns true if templateName is an "ID:" that no command of the frame will read after the calling one.
+  // the caller can then move from the model instead of copying it, the store releases it once the caller is done.
+  static bool isMovable( std::string templateName );
+
+  // free all the models and images of the calling thread, and reset cache.
+  // prefetched models and images of next frames are kept.
   static void purge( void );
 
+  // starts loading in background the models and images of the given frame, so that
+  // loadModel and loadImage return them without waiting when processing that frame.
+  // names are templates as for loadModel, IDs and videos are ignored.
+  // at most maxLoads files are loaded at the same time, and a file is not prefetched if the size
+  // of the pending files, loads in progress included, would then exceed memoryLimit bytes.
+  // files that are skipped can be prefetched by a later call, or are loaded when used.
+  static void prefetch( const uint32_t                  frame,
+                        const std::vector<std::string>& modelTemplates,
+                        const std::vector<std::string>& imageTemplates,
+                        const size_t                    maxLoads,
+                        const size_t                    memoryLimit );
+
+  // streams of the messages of the model and image loaders on the calling thread, std::cout and
+  // std::cerr by default. the background loads of prefetch write them in a buffer that is printed
+  // by the thread using the file, so that they do not mix with the messages of the processing.
+  static std::ostream& log( void );
+  static std::ostream& errorLog( void );
+
  private:
   // access to context for frame name resolution
   static Context* _context;
 
-  // model store
-  static std::map<std::string, Model*> _models;
-  // image store
-  static std::map<std::string, Image*> _images;
+  // same as resolveName but silent, used for the bookkeeping of the store
+  static std::string resolve( const uint32_t frame, const std::string& input );
+
+  // model store, one per thread so that frames can be processed concurrently,
+  // a model stays alive while the store or a command holds a reference on it
+  static thread_local std::map<std::string, std::shared_ptr<Model>> _models;
+  // image store, one per thread
+  static thread_local std::map<std::string, std::shared_ptr<Image>> _images;
+  // pending uses of the models and images of the frame processed by the thread, indexed by name
+  static thread_local std::map<std::string, size_t> _uses;
+  // loader messages streams of the thread, NULL for the defaults
+  static thread_local std::ostream* _log;
+  static thread_local std::ostream* _errorLog;
+
+  // models and images being loaded in background, indexed by frame and name
+  template <typename T>
+  struct Prefetch {
+    size_t                       bytes;  // size of the file
+    std::future<T*>              result;
+    std::shared_ptr<std::string> log;  // messages of the loader, set when result is ready
+  };
+  // starts load( name ) on a new thread, with the messages of the loader written in log
+  template <typename T>
+  static std::future<T*> launch( T* ( *load )( const std::string& ),
+                                 const std::string&           name,
+                                 std::shared_ptr<std::string> log );
+  static std::map<std::pair<uint32_t, std::string>, Prefetch<Model>> _prefetchedModels;
+  static std::map<std::pair<uint32_t, std::string>, Prefetch<Image>> _prefetchedImages;
+  static size_t                                                      _prefetchedBytes;
 
  public:
   // Automatic choice on extension
   static bool _loadModel( std::string filename, Model& output );
-  static bool _saveModel( std::string filename, const Model& input );
+  static bool _saveModel( std::string filename, const Model& input, bool binaryPly = false );
 
   // OBJ
   static bool _loadObj( std::string filename, Model& output );
@@ -77,7 +140,16 @@ class IO {
 
   // PLY
   static bool _loadPly( std::string filename, Model& output );
-  static bool _savePly( std::string filename, const Model& input );
+  static bool _savePly( std::string filename, const Model& input, bool binary = false );
+
+  // version of the obj and ply parsers, to be increased by any change of the models they produce.
+  // it is recorded in the mmb files and in the cache keys so that snapshots of older parsers are not served.
+  static const uint32_t LOADER_VERSION = 2;
+
+  // MMB, binary dump of the model arrays for fast reload of intermediate results.
+  // if loaderVersion is not NULL it is set to the LOADER_VERSION of the writer of the file.
+  static bool _loadMmb( std::string filename, Model& output, uint32_t* loaderVersion = NULL );
+  static bool _saveMmb( std::string filename, const Model& input );
 
   // Images
   static bool _loadImage( std::string filename, Image& output );
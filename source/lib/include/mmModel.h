@@ -21,8 +21,12 @@
 
 //
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <set>
 #include <map>
+#include <new>
 #include <vector>
 #include <algorithm>
 #include <functional>
@@ -65,6 +69,120 @@ class Vertex {
   }
 };
 
+// Compressed sparse row adjacency: the items of key k are items[offsets[k]] to items[offsets[k + 1] - 1],
+// stored contiguously in ascending order. Keys are dense (vertex or triangle indices), keys without
+// items or beyond size() give an empty range.
+class Adjacency {
+ public:
+  // view on the items of a key, valid until the adjacency is modified
+  class Range {
+   public:
+    Range( const uint32_t* first = nullptr, const uint32_t* last = nullptr ) : _first( first ), _last( last ) {}
+    inline const uint32_t* begin( void ) const { return _first; }
+    inline const uint32_t* end( void ) const { return _last; }
+    inline size_t          size( void ) const { return _last - _first; }
+    inline bool            empty( void ) const { return _first == _last; }
+    inline uint32_t        operator[]( const size_t i ) const { return _first[i]; }
+
+   private:
+    const uint32_t* _first;
+    const uint32_t* _last;
+  };
+
+  std::vector<size_t>   offsets;  // size() + 1 entries once built
+  std::vector<uint32_t> items;    // items of all the keys
+
+  // number of keys
+  inline size_t size( void ) const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+  inline void clear( void ) {
+    offsets.clear();
+    items.clear();
+  }
+
+  inline Range operator[]( const size_t key ) const {
+    if ( key + 1 >= offsets.size() ) return Range();
+    return Range( items.data() + offsets[key], items.data() + offsets[key + 1] );
+  }
+
+  // appends a key with the items [first, last), items must be sorted and unique
+  template <typename Iterator>
+  inline void push_back( Iterator first, Iterator last ) {
+    if ( offsets.empty() ) offsets.push_back( 0 );
+    items.insert( items.end(), first, last );
+    offsets.push_back( items.size() );
+  }
+};
+
+// allocator of arrays aligned on 64 bytes, a cache line and the widest SIMD registers
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator {
+ public:
+  typedef T value_type;
+  template <typename U>
+  struct rebind {
+    typedef AlignedAllocator<U, Alignment> other;
+  };
+
+  AlignedAllocator() noexcept {}
+  template <typename U>
+  AlignedAllocator( const AlignedAllocator<U, Alignment>& ) noexcept {}
+
+  inline T* allocate( const size_t n ) {
+    return static_cast<T*>( ::operator new( n * sizeof( T ), std::align_val_t( Alignment ) ) );
+  }
+  inline void deallocate( T* p, const size_t ) noexcept { ::operator delete( p, std::align_val_t( Alignment ) ); }
+
+  template <typename U>
+  inline bool operator==( const AlignedAllocator<U, Alignment>& ) const noexcept {
+    return true;
+  }
+  template <typename U>
+  inline bool operator!=( const AlignedAllocator<U, Alignment>& ) const noexcept {
+    return false;
+  }
+};
+
+// Three component attribute (positions, normals or colors) stored as structure of arrays, one array
+// per component aligned on 64 bytes, so that the batch functions of Geometry process consecutive
+// vertices with aligned SIMD loads. The interleaved (x,y,z) arrays of Model stay the reference storage,
+// an attribute is deinterleaved by the constructor or fromAos and written back by toAos.
+class Vec3Soa {
+ public:
+  typedef std::vector<float, AlignedAllocator<float>> Array;
+
+  Array x, y, z;
+
+  Vec3Soa() {}
+  Vec3Soa( const std::vector<float>& aos ) { fromAos( aos ); }
+
+  inline size_t size( void ) const { return x.size(); }
+  inline bool   empty( void ) const { return x.empty(); }
+
+  inline void resize( const size_t count ) {
+    x.resize( count );
+    y.resize( count );
+    z.resize( count );
+  }
+
+  // array of component c
+  inline Array&       operator[]( const glm::vec3::length_type c ) { return c == 0 ? x : ( c == 1 ? y : z ); }
+  inline const Array& operator[]( const glm::vec3::length_type c ) const { return c == 0 ? x : ( c == 1 ? y : z ); }
+
+  // element i as returned by the fetch functions of Model
+  inline glm::vec3 fetch( const size_t i ) const { return glm::vec3( x[i], y[i], z[i] ); }
+  inline void      store( const size_t i, const glm::vec3& v ) {
+    x[i] = v.x;
+    y[i] = v.y;
+    z[i] = v.z;
+  }
+
+  // deinterleaves the (x,y,z) triples of aos
+  void fromAos( const std::vector<float>& aos );
+  // interleaves the components into aos, resized to 3 * size()
+  void toAos( std::vector<float>& aos ) const;
+};
+
 // 3D Model: mesh or point cloud
 class Model {
  public:
@@ -79,15 +197,15 @@ class Model {
   std::vector<int>         trianglesuv;  // triangle uv indices
 
   // topology/neighborhood information
-  // set of triangle associated with a vertex index (the key)
-  std::map<size_t, std::set<size_t>> perVertexTriangles;
-  // set of triangles sharing at least one vertex with the key triangle
-  std::map<size_t, std::set<size_t>> perTriangleNeighborTriangles;
-  // set of triangles sharing two vertices with the key triangle (i.e. connected by an adge)
-  std::map<size_t, std::set<size_t>> perTriangleEdgeNeighborTriangles;
+  // triangles associated with a vertex index (the key)
+  Adjacency perVertexTriangles;
+  // triangles sharing at least one vertex with the key triangle
+  Adjacency perTriangleNeighborTriangles;
+  // triangles sharing two vertices with the key triangle (i.e. connected by an adge)
+  Adjacency perTriangleEdgeNeighborTriangles;
   // set of triangles which have at least one non-manifold edge
   std::set<size_t> nonManifoldTriangles;
-  // set of non manifold vertices
+  // set of non manifold vertices, i.e. whose triangles form more than one fan
   std::set<size_t> nonManifoldVertices;
 
   // ctor
@@ -149,60 +267,47 @@ class Model {
 
   // return true if a set of neighbors for a given triangle is found
   inline bool getNeighborTriangles( const size_t idx, std::set<size_t>& res ) const {
-    auto iter = perTriangleNeighborTriangles.find( idx );
-    if ( iter != perTriangleNeighborTriangles.end() ) {
-      res = iter->second;
-      return true;
-    }
-    return false;
+    const auto range = perTriangleNeighborTriangles[idx];
+    res.clear();
+    res.insert( range.begin(), range.end() );
+    return !range.empty();
   }
 
-  inline const auto getNeighborTriangles( const size_t idx ) const {
-    static const std::set<size_t> empty;  // shall be moved mutualized
-    auto                          iter = perTriangleNeighborTriangles.find( idx );
-    if ( iter != perTriangleNeighborTriangles.end() ) { return iter->second; }
-    return empty;
-  }
+  // return the neighbors of a given triangle, empty if none, no copy is made
+  inline Adjacency::Range getNeighborTriangles( const size_t idx ) const { return perTriangleNeighborTriangles[idx]; }
 
-  // return true if a set of neighbors for a given triangle is found
+  // return true if a set of neighbors by edge for a given triangle is found
   inline bool getNeighborTrianglesByEdge( const size_t idx, std::set<size_t>& res ) const {
-    auto iter = perTriangleNeighborTriangles.find( idx );
-    if ( iter != perTriangleNeighborTriangles.end() ) {
-      res = iter->second;
-      return true;
-    }
-    return false;
+    const auto range = perTriangleEdgeNeighborTriangles[idx];
+    res.clear();
+    res.insert( range.begin(), range.end() );
+    return !range.empty();
   }
 
-  inline const auto getNeighborTrianglesByEdge( const size_t idx ) const {
-    static const std::set<size_t> empty;  // shall be moved mutualized
-    auto                          iter = perTriangleEdgeNeighborTriangles.find( idx );
-    if ( iter != perTriangleEdgeNeighborTriangles.end() ) { return iter->second; }
-    return empty;
+  // return the neighbors by edge of a given triangle, empty if none, no copy is made
+  inline Adjacency::Range getNeighborTrianglesByEdge( const size_t idx ) const {
+    return perTriangleEdgeNeighborTriangles[idx];
   }
 
   // return true if a set of triangles for a given vertex is found
   inline bool getVertexTriangles( const size_t v, std::set<size_t>& res ) const {
-    auto iter = perVertexTriangles.find( v );
-    if ( iter != perVertexTriangles.end() ) {
-      res = iter->second;
-      return true;
-    }
-    return false;
+    const auto range = perVertexTriangles[v];
+    res.clear();
+    res.insert( range.begin(), range.end() );
+    return !range.empty();
   }
 
-  // return true if a set of triangles for a given vertex is found
-  inline const auto getVertexTriangles( const size_t v ) const {
-    static const std::set<size_t> empty;
-    auto                          iter = perVertexTriangles.find( v );
-    if ( iter != perVertexTriangles.end() ) { return iter->second; }
-    return empty;
-  }
+  // return the triangles of a given vertex, empty if none, no copy is made
+  inline Adjacency::Range getVertexTriangles( const size_t v ) const { return perVertexTriangles[v]; }
 
   // return true if a set of triangles for a given vertex is found
-  // std::map<size_t, std::set<size_t>> perVertexTriangles;
+  // copies perVertexTriangles into a map, only vertices having triangles are keys
   inline bool getPerVertexTriangles( std::map<size_t, std::set<size_t>>& res ) {
-    res = perVertexTriangles;
+    res.clear();
+    for ( size_t v = 0; v < perVertexTriangles.size(); ++v ) {
+      const auto range = perVertexTriangles[v];
+      if ( !range.empty() ) res[v].insert( range.begin(), range.end() );
+    }
     return true;
   }
 
@@ -315,14 +420,15 @@ class Model {
   // noSeams set to true will takes more time to compute but prevent seam effect if model has UV patches
   void computeVertexNormals( bool normalize = true, bool noSeams = true );
 
-  // generates some connectivity information in perVertexTriangles and perTriangleNeighborTriangles
+  // generates some connectivity information in perVertexTriangles, perTriangleNeighborTriangles
+  // and perTriangleEdgeNeighborTriangles, stored as compressed sparse row arrays
   // shall be re-invoked whenever mesh is updated
   // if useIndices is set to false, the algorithm bases upon exising vertex positions only:
   // - this produces the complete neighborhood for each tiangle
   // if useIndices is set to true, the algorithm bases upon existing vertex indices:
   // - two vertices with same position but different uv, color or normal are considered different
   // - this produces neighbors only if in the same connected component wrt existing index table
-  // skipNonManifold is used only if useIndices=false
+  // vertices and edges are sorted by position or index then processed in parallel, in both modes
   // if skipNonManifold=true then triangles connexity for non-manifold edges are skipped (but nonManifoldTriangles set
   // is still constructed) otherwise all the neighbor trinangles are kept
   void computeNeighborTriangles( bool useIndices = false, bool skipNonManifold = true );
@@ -367,13 +473,156 @@ struct CompareVertex {
   }
 };
 
+// Hash table of unique vertices, used by the model builders for duplicate vertex removal.
+// The key holds all the attributes (pos, uv, col, nrm) so that vertices match as
+// with CompareVertex<true, true, true, true>.
+class VertexTable {
+ public:
+  typedef std::array<float, 11> Key;
+
+  // the key values are canonical, -0 stored as +0 and any NaN as the same quiet NaN, so that keys
+  // are compared and hashed on their bits. vertices with NaN attributes, e.g. the normals of
+  // degenerate triangles, are thus merged as CompareVertex does.
+  static inline float canonical( const float f ) {
+    if ( f == 0.0f ) return 0.0f;
+    return f != f ? std::numeric_limits<float>::quiet_NaN() : f;
+  }
+
+  static inline Key makeKey( const Vertex& v ) {
+    return { canonical( v.pos.x ), canonical( v.pos.y ), canonical( v.pos.z ), canonical( v.uv.x ),
+             canonical( v.uv.y ),  canonical( v.col.x ), canonical( v.col.y ), canonical( v.col.z ),
+             canonical( v.nrm.x ), canonical( v.nrm.y ), canonical( v.nrm.z ) };
+  }
+
+  static inline bool equalKeys( const Key& a, const Key& b ) {
+    return std::memcmp( a.data(), b.data(), sizeof( Key ) ) == 0;
+  }
+
+  static inline uint64_t hashKey( const Key& key ) {
+    uint64_t h = 0;
+    for ( const float f : key ) {
+      uint32_t bits;
+      std::memcpy( &bits, &f, sizeof( bits ) );
+      h = ( h ^ bits ) * 0x9E3779B97F4A7C15ull;
+      h ^= h >> 32;
+    }
+    return h;
+  }
+
+  inline void clear( void ) {
+    _entries.clear();
+    _slots.clear();
+  }
+
+  // sizes the table for count keys, so that no rehash occurs until then
+  inline void reserve( const size_t count ) {
+    _entries.reserve( count );
+    if ( count * 2 > _slots.size() ) rehash( count * 2 );
+  }
+
+  // returns the value associated with key, found is set to true if key was already in the table,
+  // otherwise key is inserted with value
+  inline size_t insert( const Key& key, const uint64_t hash, const size_t value, bool& found ) {
+    if ( ( _entries.size() + 1 ) * 2 > _slots.size() ) grow();
+    const size_t mask = _slots.size() - 1;
+    size_t       slot = hash & mask;
+    for ( ; _slots[slot] != 0; slot = ( slot + 1 ) & mask ) {
+      const Entry& entry = _entries[_slots[slot] - 1];
+      if ( entry.hash == hash && equalKeys( entry.key, key ) ) {
+        found = true;
+        return entry.value;
+      }
+    }
+    _slots[slot] = (uint32_t)( _entries.size() + 1 );
+    _entries.push_back( { key, hash, value } );
+    found = false;
+    return value;
+  }
+
+ private:
+  // unique keys, pooled in insertion order
+  struct Entry {
+    Key      key;
+    uint64_t hash;
+    size_t   value;
+  };
+  std::vector<Entry> _entries;
+  // open addressing with linear probing, slots hold an index in _entries plus one, 0 if empty
+  std::vector<uint32_t> _slots;
+
+  // doubles the table, keeping the load factor below one half
+  inline void grow( void ) { rehash( _slots.size() * 2 ); }
+
+  // rebuilds the slots with at least minSlots slots, a power of two
+  inline void rehash( const size_t minSlots ) {
+    size_t slotCount = 1024;
+    while ( slotCount < minSlots ) slotCount *= 2;
+    std::vector<uint32_t> slots( slotCount, 0 );
+    const size_t          mask = slots.size() - 1;
+    for ( size_t i = 0; i < _entries.size(); ++i ) {
+      size_t slot = _entries[i].hash & mask;
+      while ( slots[slot] != 0 ) slot = ( slot + 1 ) & mask;
+      slots[slot] = (uint32_t)( i + 1 );
+    }
+    _slots.swap( slots );
+  }
+};
+
+// Hash set of items stored by the caller, the table only holds their indices.
+// hashOf( i ) gives the hash of item i and equal( i, j ) tells if items i and j match.
+class VertexIndexTable {
+ public:
+  // sizes the table for count items, to be invoked before the first insert
+  inline void reserve( const size_t count ) {
+    if ( _count != 0 ) return;
+    size_t slotCount = 1024;
+    while ( slotCount < count * 2 ) slotCount *= 2;
+    _slots.assign( slotCount, 0 );
+  }
+
+  // inserts item and returns false, or returns true if an equal item is already in the table
+  template <typename HashOf, typename Equal>
+  inline bool insert( const uint32_t item, HashOf hashOf, Equal equal ) {
+    if ( ( _count + 1 ) * 2 > _slots.size() ) grow( hashOf );
+    const uint64_t hash = hashOf( item );
+    const size_t   mask = _slots.size() - 1;
+    size_t         slot = hash & mask;
+    for ( ; _slots[slot] != 0; slot = ( slot + 1 ) & mask ) {
+      const uint32_t other = _slots[slot] - 1;
+      if ( hashOf( other ) == hash && equal( other, item ) ) return true;
+    }
+    _slots[slot] = item + 1;
+    _count++;
+    return false;
+  }
+
+ private:
+  // open addressing with linear probing, slots hold an item index plus one, 0 if empty
+  std::vector<uint32_t> _slots;
+  size_t                _count = 0;
+
+  // doubles the table, keeping the load factor below one half
+  template <typename HashOf>
+  inline void grow( HashOf hashOf ) {
+    std::vector<uint32_t> slots( std::max<size_t>( 1024, _slots.size() * 2 ), 0 );
+    const size_t          mask = slots.size() - 1;
+    for ( const uint32_t s : _slots ) {
+      if ( s == 0 ) continue;
+      size_t slot = hashOf( s - 1 ) & mask;
+      while ( slots[slot] != 0 ) slot = ( slot + 1 ) & mask;
+      slots[slot] = s;
+    }
+    _slots.swap( slots );
+  }
+};
+
 // Utility class to create Models using vertex
 // search for compact indexing and duplicate vertex removal
 class ModelBuilder {
   // output model
   Model* _output;
-  // set of <sorted vertices, associated index>
-  std::map<Vertex, size_t, CompareVertex<true, true, true, true>> _vset;
+  // unique vertices and their index in the output model
+  VertexTable _table;
 
  public:
   // statistics
@@ -383,36 +632,50 @@ class ModelBuilder {
   ModelBuilder( Model& output ) : _output( &output ), foundCount( 0 ) {}
 
   inline void reset( Model& output ) {
-    _vset.clear();
+    _table.clear();
     _output    = &output;
     foundCount = 0;
   }
 
-  // method to construct point clouds,  with duplicate points removal
-  // return index of the vertex
-  inline size_t pushVertex( const Vertex& v ) {
-    // push only if not exist in vset
-    auto searchIter = _vset.find( v );
-    if ( searchIter != _vset.end() ) {
-      foundCount++;
-      return searchIter->second;
-    }
-    size_t newIndex = _output->vertices.size() / 3;
-    _vset.insert( std::make_pair( v, newIndex ) );
+  // pre-allocates the table and the output arrays for count more vertices with the given attributes
+  inline void reserve( const size_t count, const bool normals, const bool uvcoords, const bool colors ) {
+    const size_t size = _output->vertices.size() / 3 + count;
+    _table.reserve( size );
+    _output->vertices.reserve( size * 3 );
+    if ( normals ) _output->normals.reserve( size * 3 );
+    if ( uvcoords ) _output->uvcoords.reserve( size * 2 );
+    if ( colors ) _output->colors.reserve( size * 3 );
+  }
 
-    for ( glm::vec3::length_type c = 0; c < 3; c++ ) { _output->vertices.push_back( v.pos[c] ); }
+  // appends the attributes of the vertex to the model
+  static inline void appendVertex( Model& output, const Vertex& v ) {
+    for ( glm::vec3::length_type c = 0; c < 3; c++ ) { output.vertices.push_back( v.pos[c] ); }
 
     if ( v.hasNormal )
-      for ( glm::vec3::length_type c = 0; c < 3; c++ ) _output->normals.push_back( v.nrm[c] );
+      for ( glm::vec3::length_type c = 0; c < 3; c++ ) output.normals.push_back( v.nrm[c] );
 
     if ( v.hasUVCoord ) {
-      for ( glm::vec3::length_type c = 0; c < 2; c++ ) _output->uvcoords.push_back( v.uv[c] );
+      for ( glm::vec3::length_type c = 0; c < 2; c++ ) output.uvcoords.push_back( v.uv[c] );
     }
 
     if ( v.hasColor ) {
-      for ( glm::vec3::length_type c = 0; c < 3; c++ ) _output->colors.push_back( v.col[c] );
+      for ( glm::vec3::length_type c = 0; c < 3; c++ ) output.colors.push_back( v.col[c] );
     }
+  }
 
+  // method to construct point clouds,  with duplicate points removal
+  // return index of the vertex
+  inline size_t pushVertex( const Vertex& v ) {
+    // push only if not already in the table
+    const VertexTable::Key key      = VertexTable::makeKey( v );
+    bool                   found    = false;
+    const size_t           newIndex = _output->vertices.size() / 3;
+    const size_t           index    = _table.insert( key, VertexTable::hashKey( key ), newIndex, found );
+    if ( found ) {
+      foundCount++;
+      return index;
+    }
+    appendVertex( *_output, v );
     return newIndex;
   }
 
@@ -460,6 +723,118 @@ class ModelBuilder {
   }
 };
 
+// Utility class to create point clouds from several threads, with duplicate points removal.
+// Vertices are pushed into blocks, e.g. one block per range of triangles, a block being filled
+// by one thread at a time. The merged model is the same as the one of a ModelBuilder fed with
+// the blocks in sequence, whatever the number of threads.
+// If a color map is given, the vertices hold the uv of their color in the map instead of their color,
+// for counts. Two vertices then match as if they held their colors, which are only fetched when the
+// vertices match on their other attributes but not on their uv.
+class ParallelModelBuilder {
+  // unique vertices of a block in push order
+  struct Block {
+    VertexIndexTable      table;
+    std::vector<Vertex>   vertices;
+    std::vector<uint64_t> hashes;
+    size_t                foundCount = 0;
+  };
+  std::vector<Block> _blocks;
+  const Image*       _colorMap;
+  bool               _bilinear;
+
+ public:
+  // statistics, set by merge
+  size_t foundCount;
+
+ public:
+  ParallelModelBuilder( size_t blockCount, const Image* colorMap = NULL, bool bilinear = false ) :
+      _blocks( blockCount ), _colorMap( colorMap ), _bilinear( bilinear ), foundCount( 0 ) {}
+
+  // hash of the vertex, the uv being left out if they stand for the colors
+  inline uint64_t hashOf( const Vertex& v ) const {
+    VertexTable::Key key = VertexTable::makeKey( v );
+    if ( _colorMap != NULL ) key[3] = key[4] = 0.0F;
+    return VertexTable::hashKey( key );
+  }
+
+  // tells if the vertices are duplicates
+  inline bool equal( const Vertex& a, const Vertex& b ) const {
+    if ( _colorMap == NULL ) return VertexTable::equalKeys( VertexTable::makeKey( a ), VertexTable::makeKey( b ) );
+    VertexTable::Key keyA = VertexTable::makeKey( a ), keyB = VertexTable::makeKey( b );
+    keyA[3] = keyA[4] = keyB[3] = keyB[4] = 0.0F;
+    if ( !VertexTable::equalKeys( keyA, keyB ) ) return false;
+    if ( a.uv == b.uv ) return true;
+    glm::vec3 colA, colB;
+    if ( _bilinear ) {
+      texture2D_bilinear( *_colorMap, a.uv, colA );
+      texture2D_bilinear( *_colorMap, b.uv, colB );
+    } else {
+      texture2D( *_colorMap, a.uv, colA );
+      texture2D( *_colorMap, b.uv, colB );
+    }
+    return colA == colB;
+  }
+
+  // pre-allocates a block for count vertices, to be invoked before its first push
+  inline void reserve( size_t block, size_t count ) {
+    Block& b = _blocks[block];
+    b.table.reserve( count );
+    b.vertices.reserve( count );
+    b.hashes.reserve( count );
+  }
+
+  // method to construct point clouds,  with duplicate points removal
+  inline void pushVertex( size_t block, const Vertex& v ) {
+    Block& b = _blocks[block];
+    b.vertices.push_back( v );
+    b.hashes.push_back( hashOf( v ) );
+    // the table refers to the vertices of the block, the new one is dropped if already there
+    if ( b.table.insert(
+           (uint32_t)( b.vertices.size() - 1 ),
+           [&b]( uint32_t i ) { return b.hashes[i]; },
+           [&b, this]( uint32_t i, uint32_t j ) { return equal( b.vertices[i], b.vertices[j] ); } ) ) {
+      b.vertices.pop_back();
+      b.hashes.pop_back();
+      b.foundCount++;
+    }
+  }
+
+  // same as ModelBuilder::pushVertex with a texture map
+  inline void pushVertex( size_t block, const Vertex& v, const Image& tex_map, const bool bilinear ) {
+    if ( v.hasUVCoord && tex_map.data != NULL ) {
+      Vertex tmp = v;
+
+      // fetch the color from the map
+      if ( bilinear )
+        texture2D_bilinear( tex_map, v.uv, tmp.col );
+      else
+        texture2D( tex_map, v.uv, tmp.col );
+
+      tmp.hasUVCoord = false;
+      tmp.hasColor   = true;
+
+      pushVertex( block, tmp );
+      return;
+    }
+
+    pushVertex( block, v );
+  }
+
+  // removes the duplicates across blocks and appends the unique vertices to output,
+  // in block order then push order. The output arrays are sized once and the blocks are
+  // copied concurrently to their ranges. The blocks are released.
+  void merge( Model& output );
+
+  // removes the duplicates across blocks and returns the number of unique vertices,
+  // nothing is output. The blocks are released.
+  size_t count();
+
+ private:
+  // flags the vertices of the blocks that are not a duplicate of a previous one,
+  // offsets[b] being the index of the first vertex of block b in unique
+  void findUnique( std::vector<size_t>& offsets, std::vector<uint8_t>& unique );
+};
+
 // fetch a triangle, no sanity check for perf reasons
 inline void fetchTriangle( const Model& model,
                            size_t       index,
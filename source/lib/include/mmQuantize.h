@@ -49,6 +49,25 @@ class Quantize {
                        glm::vec3&         minCol,
                        glm::vec3&         maxCol,
                        const bool         verbose = true);
+
+  // same as previous but quantizes the model in place, sparing the copy of the input
+  static void quantize(Model&             model,
+                       const uint32_t     qp,
+                       const uint32_t     qt,
+                       const uint32_t     qn,
+                       const uint32_t     qc,
+                       const std::string& outputVarFilename,
+                       bool               useFixedPoint,
+                       bool               colorSpaceConversion,
+                       glm::vec3&         minPos,
+                       glm::vec3&         maxPos,
+                       glm::vec2&         minUv,
+                       glm::vec2&         maxUv,
+                       glm::vec3&         minNrm,
+                       glm::vec3&         maxNrm,
+                       glm::vec3&         minCol,
+                       glm::vec3&         maxCol,
+                       const bool         verbose = true);
 };
 
 }  // namespace mm
@@ -30,17 +30,20 @@ class Sample {
   Sample(){};
 
   // sample the mesh on a face basis
-  static void meshToPcFace( const Model& input,
-                            Model&       output,
-                            const Image& tex_map,
-                            size_t       resolution,
-                            float        thickness,
-                            bool         bilinear,
-                            bool         logProgress );
+  // returns the number of points, only counted without filling output if countOnly is set
+  static size_t meshToPcFace( const Model& input,
+                              Model&       output,
+                              const Image& tex_map,
+                              size_t       resolution,
+                              float        thickness,
+                              bool         bilinear,
+                              bool         logProgress,
+                              bool         countOnly = false );
 
   // sample the mesh on a face basis
   // system will search the resolution according to the nbSamplesMin and nbSamplesMax parameters
-  // costly method, shall be used only for calibration
+  // the resolution is searched with point counts only, guided by a closed form estimate, and the model is
+  // sampled once at the resolution found
   static void meshToPcFace( const Model& input,
                             Model&       output,
                             const Image& tex_map,
@@ -53,21 +56,26 @@ class Sample {
                             size_t&      computedResolution );
 
   // will sample the mesh on a grid basis of resolution gridRes
-  static void meshToPcGrid( const Model& input,
-                            Model&       output,
-                            const Image& tex_map,
-                            size_t       gridSize,
-                            bool         bilinear,
-                            bool         logProgress,
-                            bool         useNormal,
-                            bool         useFixedPoint,
-                            glm::vec3&   minPos,
-                            glm::vec3&   maxPos,
-                            const bool   verbose = true );
+  // the grid cells covered by the triangles are found by ray casting, or by rasterization if useRaster is set
+  // returns the number of points, only counted without filling output if countOnly is set
+  static size_t meshToPcGrid( const Model& input,
+                              Model&       output,
+                              const Image& tex_map,
+                              size_t       gridSize,
+                              bool         bilinear,
+                              bool         logProgress,
+                              bool         useNormal,
+                              bool         useFixedPoint,
+                              bool         useRaster,
+                              glm::vec3&   minPos,
+                              glm::vec3&   maxPos,
+                              const bool   verbose   = true,
+                              const bool   countOnly = false );
 
   // will sample the mesh on a grid basis of resolution gridRes, result will be generated as float or integer
   // system will search the resolution according to the nbSamplesMin and nbSamplesMax parameters
-  // costly method, shall be used only for calibration
+  // the resolution is searched with point counts only, guided by a closed form estimate, and the model is
+  // sampled once at the resolution found
   static void meshToPcGrid( const Model& input,
                             Model&       output,
                             const Image& tex_map,
@@ -78,6 +86,7 @@ class Sample {
                             bool         logProgress,
                             bool         useNormal,
                             bool         useFixedPoint,
+                            bool         useRaster,
                             glm::vec3&   minPos,
                             glm::vec3&   maxPos,
                             size_t&      computedResolution );
@@ -86,17 +95,20 @@ class Sample {
   static void meshToPcMap( const Model& input, Model& output, const Image& tex_map, bool logProgress );
 
   // triangle dubdivision based, area stop criterion
-  static void meshToPcDiv( const Model& input,
-                           Model&       output,
-                           const Image& tex_map,
-                           float        areaThreshold,
-                           bool         mapThreshold,
-                           bool         bilinear,
-                           bool         logProgress );
+  // returns the number of points, only counted without filling output if countOnly is set
+  static size_t meshToPcDiv( const Model& input,
+                             Model&       output,
+                             const Image& tex_map,
+                             float        areaThreshold,
+                             bool         mapThreshold,
+                             bool         bilinear,
+                             bool         logProgress,
+                             bool         countOnly = false );
 
   // triangle dubdivision based, area stop criterion
   // system will search the resolution according to the nbSamplesMin and nbSamplesMax parameters
-  // costly method, shall be used only for calibration
+  // the threshold is searched with point counts only, guided by a closed form estimate, and the model is
+  // sampled once at the threshold found
   static void meshToPcDiv( const Model& input,
                            Model&       output,
                            const Image& tex_map,
@@ -108,18 +120,21 @@ class Sample {
                            float&       computedThres );
 
   // triangle dubdivision based, edge stop criterion
-  static void meshToPcDivEdge( const Model& input,
-                               Model&       output,
-                               const Image& tex_map,
-                               float        lengthThreshold,
-                               size_t       resolution,
-                               bool         bilinear,
-                               bool         logProgress,
-                               float&       computedThres );
+  // returns the number of points, only counted without filling output if countOnly is set
+  static size_t meshToPcDivEdge( const Model& input,
+                                 Model&       output,
+                                 const Image& tex_map,
+                                 float        lengthThreshold,
+                                 size_t       resolution,
+                                 bool         bilinear,
+                                 bool         logProgress,
+                                 float&       computedThres,
+                                 bool         countOnly = false );
 
   // triangle dubdivision based, edge stop criterion
   // system will search the resolution according to the nbSamplesMin and nbSamplesMax parameters
-  // costly method, shall be used only for calibration
+  // the threshold is searched with point counts only, guided by a closed form estimate, and the model is
+  // sampled once at the threshold found
   static void meshToPcDivEdge( const Model& input,
                                Model&       output,
                                const Image& tex_map,
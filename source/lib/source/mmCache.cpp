@@ -0,0 +1,140 @@
+// ************* COPYRIGHT AND CONFIDENTIALITY INFORMATION *********
+// Copyright 2021 - InterDigital
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+// Author: jean-eudes.marvie@interdigital.com
+// *****************************************************************
+
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "mmIO.h"
+#include "mmCache.h"
+
+using namespace mm;
+namespace fs = std::filesystem;
+
+// temporary files older than this are considered left by a crashed process
+static const auto STALE_TEMPORARY_AGE = std::chrono::hours( 1 );
+
+static std::string cacheDir( void ) {
+  const char* dir = std::getenv( "MM_CACHE_DIR" );
+  return dir == NULL ? "" : dir;
+}
+
+static uintmax_t cacheSizeLimit( void ) {
+  const char* size = std::getenv( "MM_CACHE_SIZE" );
+  uintmax_t   mb   = size == NULL ? 4096 : std::strtoull( size, NULL, 10 );
+  return mb * 1024 * 1024;
+}
+
+bool Cache::enabled( void ) { return !cacheDir().empty(); }
+
+std::string Cache::snapshotPath( const std::string& filename ) {
+  std::error_code ec;
+  const fs::path  path = fs::absolute( filename, ec );
+  if ( ec ) return "";
+  const uintmax_t size = fs::file_size( path, ec );
+  if ( ec ) return "";
+  const auto time = fs::last_write_time( path, ec );
+  if ( ec ) return "";
+
+  // FNV-1a hash of the key
+  std::ostringstream key;
+  key << path.string() << "|" << size << "|" << time.time_since_epoch().count() << "|" << IO::LOADER_VERSION;
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for ( unsigned char c : key.str() ) hash = ( hash ^ c ) * 0x100000001b3ull;
+
+  std::ostringstream name;
+  name << std::hex;
+  name.width( 16 );
+  name.fill( '0' );
+  name << hash;
+  return ( fs::path( cacheDir() ) / ( name.str() + ".mmb" ) ).string();
+}
+
+bool Cache::load( const std::string& filename, Model& output ) {
+  if ( !enabled() ) return false;
+  const std::string snapshot = snapshotPath( filename );
+  std::error_code   ec;
+  if ( snapshot.empty() || !fs::exists( snapshot, ec ) ) return false;
+  uint32_t loaderVersion = 0;
+  if ( !IO::_loadMmb( snapshot, output, &loaderVersion ) || loaderVersion != IO::LOADER_VERSION ) {
+    // corrupted, removed meanwhile by another process, or written by another parser version
+    output = Model();
+    fs::remove( snapshot, ec );
+    return false;
+  }
+  // mark as recently used
+  fs::last_write_time( snapshot, fs::file_time_type::clock::now(), ec );
+  return true;
+}
+
+void Cache::store( const std::string& filename, const Model& model ) {
+  if ( !enabled() ) return;
+  const std::string snapshot = snapshotPath( filename );
+  if ( snapshot.empty() ) return;
+  std::error_code ec;
+  fs::create_directories( cacheDir(), ec );
+
+  // write in a unique temporary file then rename, so that concurrent readers
+  // never see a partial snapshot and concurrent writers do not collide
+  std::random_device rd;
+  std::ostringstream tmp;
+  tmp << snapshot << ".tmp" << std::hex << rd() << rd();
+  if ( !IO::_saveMmb( tmp.str(), model ) ) {
+    fs::remove( tmp.str(), ec );
+    return;
+  }
+  fs::rename( tmp.str(), snapshot, ec );
+  if ( ec ) fs::remove( tmp.str(), ec );  // another process won the race
+  evict();
+}
+
+void Cache::evict( void ) {
+  struct Entry {
+    fs::path           path;
+    uintmax_t          size;
+    fs::file_time_type time;
+  };
+  std::vector<Entry> entries;
+  uintmax_t          total = 0;
+  std::error_code    ec;
+  const auto         now = fs::file_time_type::clock::now();
+  for ( fs::directory_iterator it( cacheDir(), ec ), end; !ec && it != end; it.increment( ec ) ) {
+    const fs::path  path = it->path();
+    const auto      time = fs::last_write_time( path, ec );
+    const uintmax_t size = fs::file_size( path, ec );
+    if ( ec ) continue;
+    if ( path.extension() == ".mmb" ) {
+      entries.push_back( { path, size, time } );
+      total += size;
+    } else if ( path.filename().string().find( ".mmb.tmp" ) != std::string::npos && now - time > STALE_TEMPORARY_AGE ) {
+      fs::remove( path, ec );
+    }
+  }
+  const uintmax_t limit = cacheSizeLimit();
+  if ( total <= limit ) return;
+  std::sort( entries.begin(), entries.end(), []( const Entry& a, const Entry& b ) { return a.time < b.time; } );
+  for ( size_t i = 0; i < entries.size() && total > limit; ++i ) {
+    fs::remove( entries[i].path, ec );
+    total -= entries[i].size;
+  }
+}
@@ -79,11 +79,21 @@ inline bool areTrianglesEqual( bool              unoriented,
                    || ( vA1 == vB2 && vA2 == vB1 && vA3 == vB3 ) ) );
 }
 
-Compare::Compare() : _hwRendererInitialized( false ) {}
+Compare::Compare() : _frameIndex( 0 ), _hwRendererInitialized( false ) {}
 Compare::~Compare() {
   if ( _hwRendererInitialized ) { _hwRenderer.shutdown(); }
 }
 
+void Compare::merge( const Compare& other ) {
+  _pccResults.insert( _pccResults.end(), other._pccResults.begin(), other._pccResults.end() );
+  _pcqmResults.insert( _pcqmResults.end(), other._pcqmResults.begin(), other._pcqmResults.end() );
+  _ibsmResults.insert( _ibsmResults.end(), other._ibsmResults.begin(), other._ibsmResults.end() );
+  auto byFrame = []( const auto& a, const auto& b ) { return std::get<0>( a ) < std::get<0>( b ); };
+  std::stable_sort( _pccResults.begin(), _pccResults.end(), byFrame );
+  std::stable_sort( _pcqmResults.begin(), _pcqmResults.end(), byFrame );
+  std::stable_sort( _ibsmResults.begin(), _ibsmResults.end(), byFrame );
+}
+
 int Compare::equ( const mm::Model& inputA,
                   const mm::Model& inputB,
                   const mm::Image& mapA,
@@ -420,8 +430,17 @@ int Compare::topo( const mm::Model&   modelA,
   return true;
 }
 
-void sampleIfNeeded( const mm::Model& input, const mm::Image& map, mm::Model& output ) {
+// if movable, input is consumed: its memory is reused instead of copying the model
+void sampleIfNeeded( mm::Model& input, const mm::Image& map, mm::Model& output, const bool movable ) {
   if ( input.triangles.size() != 0 ) {
+    if ( movable ) {
+      // the reordered model is built into output, the input is freed and then receives the samples
+      reorder( input, std::string( "oriented" ), output );
+      input = mm::Model();
+      mm::Sample::meshToPcDiv( output, input, map, 2.0, false, true, false );
+      std::swap( input, output );
+      return;
+    }
     // first reorder the model to prevent small variations
     // when having two similar topologies but not same orders of enumeration
     mm::Model reordered;
@@ -430,6 +449,8 @@ void sampleIfNeeded( const mm::Model& input, const mm::Image& map, mm::Model& ou
     // then use face subdivision without map citerion and area threshold of 2.0
     mm::Sample::meshToPcDiv( reordered, output, map, 2.0, false, true, false );
 
+  } else if ( movable ) {
+    output = std::move( input );  //  pass through
   } else {
     output = input;  //  pass through
   }
@@ -584,17 +605,19 @@ void convertModel( const mm::Model&         inputModel,
   removeDuplicatePoints( outputModel, params.dropDuplicates, params.neighborsProc, verbose );
 }
 
-int Compare::pcc( const mm::Model&         modelA,
-                  const mm::Model&         modelB,
+int Compare::pcc( mm::Model&               modelA,
+                  mm::Model&               modelB,
                   const mm::Image&         mapA,
                   const mm::Image&         mapB,
                   pcc_quality::commandPar& params,
                   mm::Model&               outputA,
                   mm::Model&               outputB,
-                  const bool               verbose ) {
+                  const bool               verbose,
+                  const bool               movableA,
+                  const bool               movableB ) {
   // 1 - sample the models if needed
-  sampleIfNeeded( modelA, mapA, outputA );
-  sampleIfNeeded( modelB, mapB, outputB );
+  sampleIfNeeded( modelA, mapA, outputA, movableA );
+  sampleIfNeeded( modelB, mapB, outputB, movableB );
 
   // 2 - transcode to PCC internal format
   pcc_processing::PccPointCloud inCloud1;
@@ -628,7 +651,7 @@ int Compare::pcc( const mm::Model&         modelA,
   computeQualityMetric( inCloud1, inCloud1, inCloud2, params, qm, verbose, similarPointThreshold );
 
   // store results to compute statistics in finalize step
-  _pccResults.push_back( std::make_pair( (uint32_t)_pccResults.size(), qm ) );
+  _pccResults.push_back( std::make_pair( _frameIndex, qm ) );
 
   //
   return 0;
@@ -704,8 +727,8 @@ void convertModel( const mm::Model& inputModel, PointSet& outputModel ) {
   }
 }
 
-int Compare::pcqm( const mm::Model& modelA,
-                   const mm::Model& modelB,
+int Compare::pcqm( mm::Model&       modelA,
+                   mm::Model&       modelB,
                    const mm::Image& mapA,
                    const mm::Image& mapB,
                    const double     radiusCurvature,
@@ -713,10 +736,12 @@ int Compare::pcqm( const mm::Model& modelA,
                    const double     radiusFactor,
                    mm::Model&       outputA,
                    mm::Model&       outputB,
-                   const bool       verbose ) {
+                   const bool       verbose,
+                   const bool       movableA,
+                   const bool       movableB ) {
   // 1 - sample the models if needed
-  sampleIfNeeded( modelA, mapA, outputA );
-  sampleIfNeeded( modelB, mapB, outputB );
+  sampleIfNeeded( modelA, mapA, outputA, movableA );
+  sampleIfNeeded( modelB, mapB, outputB, movableB );
 
   // 2 - transcode to PCQM internal format
   PointSet inCloud1;
@@ -744,7 +769,7 @@ int Compare::pcqm( const mm::Model& modelA,
   std::cout << "PCQM-PSNR=" << pcqmPsnr << std::endl;
 
   // store results to compute statistics
-  _pcqmResults.push_back( std::make_tuple( (uint32_t)_pcqmResults.size(), pcqm, pcqmPsnr ) );
+  _pcqmResults.push_back( std::make_tuple( _frameIndex, pcqm, pcqmPsnr ) );
 
   //
   return 0;
@@ -929,7 +954,7 @@ int Compare::ibsm( const mm::Model&   modelA,
     }
     if ( outputPrefix != "" ) {
       const std::string fullPrefix =
-        outputPrefix + "_" + std::to_string( _ibsmResults.size() ) + "_" + std::to_string( camIdx ) + "_";
+        outputPrefix + "_" + std::to_string( _frameIndex ) + "_" + std::to_string( camIdx ) + "_";
 
       // Write image Y-flipped because OpenGL
       stbi_write_png( ( fullPrefix + "ref.png" ).c_str(),
@@ -1111,7 +1136,7 @@ int Compare::ibsm( const mm::Model&   modelA,
     std::cout << "GEO PSNR = " << res.depthPSNR << std::endl;
   }
   // store results to compute statistics
-  _ibsmResults.push_back( std::make_pair( (uint32_t)_ibsmResults.size(), res ) );
+  _ibsmResults.push_back( std::make_pair( _frameIndex, res ) );
 
   return 0;
 }
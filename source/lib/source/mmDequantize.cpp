@@ -90,12 +90,16 @@ void Dequantize::dequantize( const Model&     input,
       std::cout << "  scale=" << scale << std::endl;
     }
 
-    for ( size_t i = 0; i < input.vertices.size() / 3; i++ ) {
-      for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
-        // output.vertices[i * 3 + c] = (input.vertices[i * 3 + c] * range / maxQuantizedValue) + minBox[c];
-        output.vertices[i * 3 + c] = ( input.vertices[i * 3 + c] * scale ) + minBox[c];
+    // one array per component, vectorized by compiler
+    Vec3Soa positions( input.vertices );
+    for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
+      float* values = positions[c].data();
+      for ( size_t i = 0; i < positions.size(); i++ ) {
+        // values[i] = (values[i] * range / maxQuantizedValue) + minBox[c];
+        values[i] = ( values[i] * scale ) + minBox[c];
       }
     }
+    positions.toAos( output.vertices );
   }
 
   // dequantize UV coordinates
@@ -132,11 +136,12 @@ void Dequantize::dequantize( const Model&     input,
       std::cout << "  maxNrm=\"" << maxBox.x << " " << maxBox.y << " " << maxBox.z << "\"" << std::endl;
       std::cout << "  rangeNrm=" << range << std::endl;
     }
-    for ( size_t i = 0; i < input.normals.size() / 3; i++ ) {
-      for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
-        output.normals[i * 3 + c] = ( input.normals[i * 3 + c] * range / maxQuantizedValue ) + minBox[c];
-      }
+    Vec3Soa normals( input.normals );
+    for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
+      float* values = normals[c].data();
+      for ( size_t i = 0; i < normals.size(); i++ ) values[i] = ( values[i] * range / maxQuantizedValue ) + minBox[c];
     }
+    normals.toAos( output.normals );
   }
 
   // dequantize colors
@@ -152,21 +157,22 @@ void Dequantize::dequantize( const Model&     input,
       std::cout << "  maxCol=\"" << maxBox.x << " " << maxBox.y << " " << maxBox.z << "\"" << std::endl;
       std::cout << "  rangeCol=" << range << std::endl;
     }
-    for ( size_t i = 0; i < input.colors.size() / 3; i++ ) {
-      if ( colorSpaceConversion ) {
+    Vec3Soa colors( input.colors );
+    if ( colorSpaceConversion ) {
+      // vectorized by compiler
+      for ( size_t i = 0; i < colors.size(); i++ ) {
         glm::vec3 inYUV, inYUV_256, inRGB_256;
-        // vectorized by compiler
-        for ( glm::vec3::length_type c = 0; c < 3; ++c ) { inYUV[c] = ( input.colors[i * 3 + c] / maxQuantizedValue ); }
+        for ( glm::vec3::length_type c = 0; c < 3; ++c ) { inYUV[c] = ( colors[c][i] / maxQuantizedValue ); }
         colorUnitTo256( inYUV, inYUV_256 );
         yuvBt709ToRgb_256( inYUV, inRGB_256 );
-
-        // vectorized by compiler
-        for ( glm::vec3::length_type c = 0; c < 3; ++c ) { output.colors[i * 3 + c] = inRGB_256[c]; }
-      } else {
-        for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
-          output.colors[i * 3 + c] = ( input.colors[i * 3 + c] * range / maxQuantizedValue ) + minBox[c];
-        }
+        colors.store( i, inRGB_256 );
+      }
+    } else {
+      for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
+        float* values = colors[c].data();
+        for ( size_t i = 0; i < colors.size(); i++ ) values[i] = ( values[i] * range / maxQuantizedValue ) + minBox[c];
       }
     }
+    colors.toAos( output.colors );
   }
 }
@@ -17,11 +17,28 @@
 // *****************************************************************
 
 //
+#include <cmath>
 #include <vector>
 #include "glm/glm.hpp"
 //
 #include "mmGeometry.h"
 
+// SSE2 and AVX2 kernels are compiled on x86 whatever the compiler flags and selected at runtime
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+#define MM_SIMD_X86
+#include <immintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define MM_TARGET_SSE2 __attribute__( ( target( "sse2" ) ) )
+#define MM_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#else
+#define MM_TARGET_SSE2
+#define MM_TARGET_AVX2
+#endif
+#endif
+
 using namespace mm;
 
 // Compute barycentric coordinates (u, v, w)~res(x,y,z) for
@@ -93,3 +110,602 @@ bool Geometry::evalRayTriangle( const glm::vec3& rayOrigin,
 
   return true;
 }
+
+namespace {
+
+// terms of evalRayTriangle that only depend on the ray direction and the triangle
+struct RayTriangleSetup {
+  glm::vec3 dir;
+  glm::vec3 v0;
+  glm::vec3 edge1;
+  glm::vec3 edge2;
+  glm::vec3 pvec;
+  float     inv_det;
+};
+
+// same operations and order as evalRayTriangle, the early exits aside, so that results are bit exact
+size_t evalRayTriangleScalar( const RayTriangleSetup& s,
+                              const size_t            first,
+                              const size_t            count,
+                              const float*            originX,
+                              const float*            originY,
+                              const float*            originZ,
+                              float*                  t,
+                              float*                  u,
+                              float*                  v,
+                              uint8_t*                hits ) {
+  size_t hitCount = 0;
+  for ( size_t i = first; i < count; ++i ) {
+    const glm::vec3 tvec = glm::vec3( originX[i], originY[i], originZ[i] ) - s.v0;
+    const float     uu   = glm::dot( tvec, s.pvec ) * s.inv_det;
+    hits[i]              = 0;
+    if ( uu < 0.0f || uu > 1.0f ) continue;
+    const glm::vec3 qvec = glm::cross( tvec, s.edge1 );
+    const float     vv   = glm::dot( s.dir, qvec ) * s.inv_det;
+    if ( vv < 0.0f || uu + vv > 1.0f ) continue;
+    t[i]    = glm::dot( s.edge2, qvec ) * s.inv_det;
+    u[i]    = uu;
+    v[i]    = vv;
+    hits[i] = 1;
+    ++hitCount;
+  }
+  return hitCount;
+}
+
+// same operations as Model::normalizeNormals, from vector first to count
+void normalizeScalar( const size_t first, const size_t count, float* vectors ) {
+  for ( size_t i = first; i < count; ++i ) {
+    glm::vec3 v = glm::normalize( glm::vec3( vectors[i * 3 + 0], vectors[i * 3 + 1], vectors[i * 3 + 2] ) );
+    // use default z normal if invalid
+    if ( std::isnan( v[0] ) ) v = glm::vec3( 0.0F, 0.0F, 1.0F );
+    for ( glm::vec3::length_type c = 0; c < 3; c++ ) vectors[i * 3 + c] = v[c];
+  }
+}
+
+// same operations and order as Geometry::computeBBox on one component, from value first to count
+void minMaxScalar( const size_t first, const size_t count, const float* values, float& minValue, float& maxValue ) {
+  for ( size_t i = first; i < count; ++i ) {
+    minValue = std::fmin( values[i], minValue );
+    maxValue = std::fmax( values[i], maxValue );
+  }
+}
+
+// packets compare the values in another order than the scalar code, which only matters for the sign of
+// a zero bound. the scalar code keeps the initial bound if it is zero, else the first zero value.
+float zeroBound( const float bound, const float initial, const size_t count, const float* values ) {
+  if ( bound != 0.0f ) return bound;
+  if ( initial == 0.0f ) return initial;
+  for ( size_t i = 0; i < count; ++i ) {
+    if ( values[i] == 0.0f ) return values[i];
+  }
+  return bound;
+}
+
+// position quantization of Quantize::quantize
+inline float quantizeScalar( const float value, const float minValue, const double scale ) {
+  return static_cast<float>( static_cast<uint32_t>( std::floor( ( double( value - minValue ) ) / scale + 0.5f ) ) );
+}
+
+// normal and color quantization of Quantize::quantize
+inline float quantizeScalar( const float value, const float minValue, const float range, const float maxValue ) {
+  return static_cast<float>(
+    static_cast<uint32_t>( std::floor( ( ( value - minValue ) / range ) * maxValue + 0.5f ) ) );
+}
+
+inline bool isAligned( const void* pointer, const size_t alignment ) {
+  return reinterpret_cast<uintptr_t>( pointer ) % alignment == 0;
+}
+
+#ifdef MM_SIMD_X86
+
+// processes the rays by packets of 4, returns the number of rays processed
+MM_TARGET_SSE2 size_t evalRayTriangleSse2( const RayTriangleSetup& s,
+                                           const size_t            count,
+                                           const float*            originX,
+                                           const float*            originY,
+                                           const float*            originZ,
+                                           float*                  t,
+                                           float*                  u,
+                                           float*                  v,
+                                           uint8_t*                hits,
+                                           size_t&                 hitCount ) {
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one  = _mm_set1_ps( 1.0f );
+  const __m128 dx = _mm_set1_ps( s.dir.x ), dy = _mm_set1_ps( s.dir.y ), dz = _mm_set1_ps( s.dir.z );
+  const __m128 ox = _mm_set1_ps( s.v0.x ), oy = _mm_set1_ps( s.v0.y ), oz = _mm_set1_ps( s.v0.z );
+  const __m128 e1x = _mm_set1_ps( s.edge1.x ), e1y = _mm_set1_ps( s.edge1.y ), e1z = _mm_set1_ps( s.edge1.z );
+  const __m128 e2x = _mm_set1_ps( s.edge2.x ), e2y = _mm_set1_ps( s.edge2.y ), e2z = _mm_set1_ps( s.edge2.z );
+  const __m128 px = _mm_set1_ps( s.pvec.x ), py = _mm_set1_ps( s.pvec.y ), pz = _mm_set1_ps( s.pvec.z );
+  const __m128 invDet = _mm_set1_ps( s.inv_det );
+  size_t       i      = 0;
+  for ( ; i + 4 <= count; i += 4 ) {
+    const __m128 tx = _mm_sub_ps( _mm_loadu_ps( originX + i ), ox );
+    const __m128 ty = _mm_sub_ps( _mm_loadu_ps( originY + i ), oy );
+    const __m128 tz = _mm_sub_ps( _mm_loadu_ps( originZ + i ), oz );
+    const __m128 uu = _mm_mul_ps(
+      _mm_add_ps( _mm_add_ps( _mm_mul_ps( tx, px ), _mm_mul_ps( ty, py ) ), _mm_mul_ps( tz, pz ) ), invDet );
+    const __m128 qx = _mm_sub_ps( _mm_mul_ps( ty, e1z ), _mm_mul_ps( e1y, tz ) );
+    const __m128 qy = _mm_sub_ps( _mm_mul_ps( tz, e1x ), _mm_mul_ps( e1z, tx ) );
+    const __m128 qz = _mm_sub_ps( _mm_mul_ps( tx, e1y ), _mm_mul_ps( e1x, ty ) );
+    const __m128 vv = _mm_mul_ps(
+      _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, qx ), _mm_mul_ps( dy, qy ) ), _mm_mul_ps( dz, qz ) ), invDet );
+    const __m128 tt = _mm_mul_ps(
+      _mm_add_ps( _mm_add_ps( _mm_mul_ps( e2x, qx ), _mm_mul_ps( e2y, qy ) ), _mm_mul_ps( e2z, qz ) ), invDet );
+    // ordered comparisons, a NaN is not rejected as in evalRayTriangle
+    const __m128 reject = _mm_or_ps( _mm_or_ps( _mm_cmplt_ps( uu, zero ), _mm_cmpgt_ps( uu, one ) ),
+                                     _mm_or_ps( _mm_cmplt_ps( vv, zero ), _mm_cmpgt_ps( _mm_add_ps( uu, vv ), one ) ) );
+    const int    mask   = _mm_movemask_ps( reject );
+    _mm_storeu_ps( t + i, tt );
+    _mm_storeu_ps( u + i, uu );
+    _mm_storeu_ps( v + i, vv );
+    for ( size_t k = 0; k < 4; ++k ) {
+      hits[i + k] = ( mask >> k & 1 ) ? 0 : 1;
+      hitCount += hits[i + k];
+    }
+  }
+  return i;
+}
+
+// processes the rays by packets of 8, returns the number of rays processed
+MM_TARGET_AVX2 size_t evalRayTriangleAvx2( const RayTriangleSetup& s,
+                                           const size_t            count,
+                                           const float*            originX,
+                                           const float*            originY,
+                                           const float*            originZ,
+                                           float*                  t,
+                                           float*                  u,
+                                           float*                  v,
+                                           uint8_t*                hits,
+                                           size_t&                 hitCount ) {
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one  = _mm256_set1_ps( 1.0f );
+  const __m256 dx = _mm256_set1_ps( s.dir.x ), dy = _mm256_set1_ps( s.dir.y ), dz = _mm256_set1_ps( s.dir.z );
+  const __m256 ox = _mm256_set1_ps( s.v0.x ), oy = _mm256_set1_ps( s.v0.y ), oz = _mm256_set1_ps( s.v0.z );
+  const __m256 e1x = _mm256_set1_ps( s.edge1.x ), e1y = _mm256_set1_ps( s.edge1.y ),
+               e1z = _mm256_set1_ps( s.edge1.z );
+  const __m256 e2x = _mm256_set1_ps( s.edge2.x ), e2y = _mm256_set1_ps( s.edge2.y ),
+               e2z = _mm256_set1_ps( s.edge2.z );
+  const __m256 px = _mm256_set1_ps( s.pvec.x ), py = _mm256_set1_ps( s.pvec.y ), pz = _mm256_set1_ps( s.pvec.z );
+  const __m256 invDet = _mm256_set1_ps( s.inv_det );
+  size_t       i      = 0;
+  // no fused multiply add, it would break the bit exactness with evalRayTriangle
+  for ( ; i + 8 <= count; i += 8 ) {
+    const __m256 tx = _mm256_sub_ps( _mm256_loadu_ps( originX + i ), ox );
+    const __m256 ty = _mm256_sub_ps( _mm256_loadu_ps( originY + i ), oy );
+    const __m256 tz = _mm256_sub_ps( _mm256_loadu_ps( originZ + i ), oz );
+    const __m256 uu = _mm256_mul_ps(
+      _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( tx, px ), _mm256_mul_ps( ty, py ) ), _mm256_mul_ps( tz, pz ) ),
+      invDet );
+    const __m256 qx = _mm256_sub_ps( _mm256_mul_ps( ty, e1z ), _mm256_mul_ps( e1y, tz ) );
+    const __m256 qy = _mm256_sub_ps( _mm256_mul_ps( tz, e1x ), _mm256_mul_ps( e1z, tx ) );
+    const __m256 qz = _mm256_sub_ps( _mm256_mul_ps( tx, e1y ), _mm256_mul_ps( e1x, ty ) );
+    const __m256 vv = _mm256_mul_ps(
+      _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( dx, qx ), _mm256_mul_ps( dy, qy ) ), _mm256_mul_ps( dz, qz ) ),
+      invDet );
+    const __m256 tt = _mm256_mul_ps(
+      _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( e2x, qx ), _mm256_mul_ps( e2y, qy ) ), _mm256_mul_ps( e2z, qz ) ),
+      invDet );
+    // ordered comparisons, a NaN is not rejected as in evalRayTriangle
+    const __m256 reject =
+      _mm256_or_ps( _mm256_or_ps( _mm256_cmp_ps( uu, zero, _CMP_LT_OQ ), _mm256_cmp_ps( uu, one, _CMP_GT_OQ ) ),
+                    _mm256_or_ps( _mm256_cmp_ps( vv, zero, _CMP_LT_OQ ),
+                                  _mm256_cmp_ps( _mm256_add_ps( uu, vv ), one, _CMP_GT_OQ ) ) );
+    const int mask = _mm256_movemask_ps( reject );
+    _mm256_storeu_ps( t + i, tt );
+    _mm256_storeu_ps( u + i, uu );
+    _mm256_storeu_ps( v + i, vv );
+    for ( size_t k = 0; k < 8; ++k ) {
+      hits[i + k] = ( mask >> k & 1 ) ? 0 : 1;
+      hitCount += hits[i + k];
+    }
+  }
+  return i;
+}
+
+// same operations as normalizeScalar on packets of 4 vectors, returns the number of vectors processed
+MM_TARGET_SSE2 size_t normalizeSse2( const size_t count, float* vectors ) {
+  const __m128 one = _mm_set1_ps( 1.0f );
+  size_t       i   = 0;
+  for ( ; i + 4 <= count; i += 4 ) {
+    const float* p = &vectors[i * 3];
+    const __m128 x = _mm_set_ps( p[9], p[6], p[3], p[0] );
+    const __m128 y = _mm_set_ps( p[10], p[7], p[4], p[1] );
+    const __m128 z = _mm_set_ps( p[11], p[8], p[5], p[2] );
+    const __m128 dot     = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+    const __m128 inv     = _mm_div_ps( one, _mm_sqrt_ps( dot ) );
+    const __m128 nx      = _mm_mul_ps( x, inv );
+    const __m128 invalid = _mm_cmpunord_ps( nx, nx );
+    alignas( 16 ) float n[3][4];
+    _mm_store_ps( n[0], _mm_andnot_ps( invalid, nx ) );
+    _mm_store_ps( n[1], _mm_andnot_ps( invalid, _mm_mul_ps( y, inv ) ) );
+    _mm_store_ps( n[2], _mm_or_ps( _mm_and_ps( invalid, one ), _mm_andnot_ps( invalid, _mm_mul_ps( z, inv ) ) ) );
+    for ( size_t k = 0; k < 4; ++k ) {
+      for ( size_t c = 0; c < 3; ++c ) vectors[( i + k ) * 3 + c] = n[c][k];
+    }
+  }
+  return i;
+}
+
+// same operations as normalizeSse2 on packets of 8 vectors
+MM_TARGET_AVX2 size_t normalizeAvx2( const size_t count, float* vectors ) {
+  const __m256i stride = _mm256_setr_epi32( 0, 3, 6, 9, 12, 15, 18, 21 );
+  const __m256  one    = _mm256_set1_ps( 1.0f );
+  size_t        i      = 0;
+  for ( ; i + 8 <= count; i += 8 ) {
+    const float* p = &vectors[i * 3];
+    const __m256 x = _mm256_i32gather_ps( p, stride, 4 );
+    const __m256 y = _mm256_i32gather_ps( p + 1, stride, 4 );
+    const __m256 z = _mm256_i32gather_ps( p + 2, stride, 4 );
+    const __m256 dot =
+      _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, x ), _mm256_mul_ps( y, y ) ), _mm256_mul_ps( z, z ) );
+    const __m256 inv     = _mm256_div_ps( one, _mm256_sqrt_ps( dot ) );
+    const __m256 nx      = _mm256_mul_ps( x, inv );
+    const __m256 invalid = _mm256_cmp_ps( nx, nx, _CMP_UNORD_Q );
+    alignas( 32 ) float n[3][8];
+    _mm256_store_ps( n[0], _mm256_andnot_ps( invalid, nx ) );
+    _mm256_store_ps( n[1], _mm256_andnot_ps( invalid, _mm256_mul_ps( y, inv ) ) );
+    _mm256_store_ps( n[2], _mm256_blendv_ps( _mm256_mul_ps( z, inv ), one, invalid ) );
+    for ( size_t k = 0; k < 8; ++k ) {
+      for ( size_t c = 0; c < 3; ++c ) vectors[( i + k ) * 3 + c] = n[c][k];
+    }
+  }
+  return i;
+}
+
+// same operations as minMaxScalar on packets of 4 values, returns the number of values processed.
+// the value is the first operand of min and max so that nan values are skipped as by std::fmin and std::fmax.
+template <bool Aligned>
+MM_TARGET_SSE2 size_t minMaxSse2( const size_t count, const float* values, float& minValue, float& maxValue ) {
+  __m128 mn = _mm_set1_ps( minValue );
+  __m128 mx = _mm_set1_ps( maxValue );
+  size_t i  = 0;
+  for ( ; i + 4 <= count; i += 4 ) {
+    const __m128 v = Aligned ? _mm_load_ps( values + i ) : _mm_loadu_ps( values + i );
+    mn             = _mm_min_ps( v, mn );
+    mx             = _mm_max_ps( v, mx );
+  }
+  alignas( 16 ) float bounds[2][4];
+  _mm_store_ps( bounds[0], mn );
+  _mm_store_ps( bounds[1], mx );
+  for ( size_t k = 0; k < 4; ++k ) {
+    minValue = std::fmin( bounds[0][k], minValue );
+    maxValue = std::fmax( bounds[1][k], maxValue );
+  }
+  return i;
+}
+
+// same operations as minMaxSse2 on packets of 8 values
+template <bool Aligned>
+MM_TARGET_AVX2 size_t minMaxAvx2( const size_t count, const float* values, float& minValue, float& maxValue ) {
+  __m256 mn = _mm256_set1_ps( minValue );
+  __m256 mx = _mm256_set1_ps( maxValue );
+  size_t i  = 0;
+  for ( ; i + 8 <= count; i += 8 ) {
+    const __m256 v = Aligned ? _mm256_load_ps( values + i ) : _mm256_loadu_ps( values + i );
+    mn             = _mm256_min_ps( v, mn );
+    mx             = _mm256_max_ps( v, mx );
+  }
+  alignas( 32 ) float bounds[2][8];
+  _mm256_store_ps( bounds[0], mn );
+  _mm256_store_ps( bounds[1], mx );
+  for ( size_t k = 0; k < 8; ++k ) {
+    minValue = std::fmin( bounds[0][k], minValue );
+    maxValue = std::fmax( bounds[1][k], maxValue );
+  }
+  return i;
+}
+
+// same operations as the position quantizeScalar on packets of 4 values, returns the number of values processed.
+// floor is a truncation for the values in [0, 2^31), packets with other values are left to quantizeScalar.
+template <bool Aligned>
+MM_TARGET_SSE2 size_t quantizeSse2( const size_t count, float* values, const float minValue, const double scale ) {
+  const __m128  offset = _mm_set1_ps( minValue );
+  const __m128d div    = _mm_set1_pd( scale );
+  const __m128d half   = _mm_set1_pd( 0.5 );
+  const __m128d zero   = _mm_setzero_pd();
+  const __m128d limit  = _mm_set1_pd( 2147483648.0 );
+  size_t        i      = 0;
+  for ( ; i + 4 <= count; i += 4 ) {
+    float*        p  = values + i;
+    const __m128  d  = _mm_sub_ps( Aligned ? _mm_load_ps( p ) : _mm_loadu_ps( p ), offset );
+    const __m128d lo = _mm_add_pd( _mm_div_pd( _mm_cvtps_pd( d ), div ), half );
+    const __m128d hi = _mm_add_pd( _mm_div_pd( _mm_cvtps_pd( _mm_movehl_ps( d, d ) ), div ), half );
+    const __m128d in = _mm_and_pd( _mm_and_pd( _mm_cmpge_pd( lo, zero ), _mm_cmplt_pd( lo, limit ) ),
+                                   _mm_and_pd( _mm_cmpge_pd( hi, zero ), _mm_cmplt_pd( hi, limit ) ) );
+    if ( _mm_movemask_pd( in ) != 3 ) {
+      for ( size_t k = 0; k < 4; ++k ) p[k] = quantizeScalar( p[k], minValue, scale );
+      continue;
+    }
+    const __m128 q = _mm_cvtepi32_ps( _mm_unpacklo_epi64( _mm_cvttpd_epi32( lo ), _mm_cvttpd_epi32( hi ) ) );
+    if ( Aligned ) _mm_store_ps( p, q );
+    else _mm_storeu_ps( p, q );
+  }
+  return i;
+}
+
+// same operations as quantizeSse2 on packets of 8 values
+template <bool Aligned>
+MM_TARGET_AVX2 size_t quantizeAvx2( const size_t count, float* values, const float minValue, const double scale ) {
+  const __m256  offset = _mm256_set1_ps( minValue );
+  const __m256d div    = _mm256_set1_pd( scale );
+  const __m256d half   = _mm256_set1_pd( 0.5 );
+  const __m256d zero   = _mm256_setzero_pd();
+  const __m256d limit  = _mm256_set1_pd( 2147483648.0 );
+  size_t        i      = 0;
+  for ( ; i + 8 <= count; i += 8 ) {
+    float*        p  = values + i;
+    const __m256  d  = _mm256_sub_ps( Aligned ? _mm256_load_ps( p ) : _mm256_loadu_ps( p ), offset );
+    const __m256d lo = _mm256_add_pd( _mm256_div_pd( _mm256_cvtps_pd( _mm256_castps256_ps128( d ) ), div ), half );
+    const __m256d hi = _mm256_add_pd( _mm256_div_pd( _mm256_cvtps_pd( _mm256_extractf128_ps( d, 1 ) ), div ), half );
+    const __m256d in =
+      _mm256_and_pd( _mm256_and_pd( _mm256_cmp_pd( lo, zero, _CMP_GE_OQ ), _mm256_cmp_pd( lo, limit, _CMP_LT_OQ ) ),
+                     _mm256_and_pd( _mm256_cmp_pd( hi, zero, _CMP_GE_OQ ), _mm256_cmp_pd( hi, limit, _CMP_LT_OQ ) ) );
+    if ( _mm256_movemask_pd( in ) != 15 ) {
+      for ( size_t k = 0; k < 8; ++k ) p[k] = quantizeScalar( p[k], minValue, scale );
+      continue;
+    }
+    const __m256i q = _mm256_inserti128_si256(
+      _mm256_castsi128_si256( _mm256_cvttpd_epi32( lo ) ), _mm256_cvttpd_epi32( hi ), 1 );
+    if ( Aligned ) _mm256_store_ps( p, _mm256_cvtepi32_ps( q ) );
+    else _mm256_storeu_ps( p, _mm256_cvtepi32_ps( q ) );
+  }
+  return i;
+}
+
+// same operations as the normal and color quantizeScalar on packets of 4 values, as quantizeSse2
+template <bool Aligned>
+MM_TARGET_SSE2 size_t quantizeSse2( const size_t count,
+                                    float*       values,
+                                    const float  minValue,
+                                    const float  range,
+                                    const float  maxValue ) {
+  const __m128 offset = _mm_set1_ps( minValue );
+  const __m128 div    = _mm_set1_ps( range );
+  const __m128 mul    = _mm_set1_ps( maxValue );
+  const __m128 half   = _mm_set1_ps( 0.5f );
+  const __m128 zero   = _mm_setzero_ps();
+  const __m128 limit  = _mm_set1_ps( 2147483648.0f );
+  size_t       i      = 0;
+  for ( ; i + 4 <= count; i += 4 ) {
+    float*       p = values + i;
+    const __m128 v = Aligned ? _mm_load_ps( p ) : _mm_loadu_ps( p );
+    const __m128 t = _mm_add_ps( _mm_mul_ps( _mm_div_ps( _mm_sub_ps( v, offset ), div ), mul ), half );
+    if ( _mm_movemask_ps( _mm_and_ps( _mm_cmpge_ps( t, zero ), _mm_cmplt_ps( t, limit ) ) ) != 15 ) {
+      for ( size_t k = 0; k < 4; ++k ) p[k] = quantizeScalar( p[k], minValue, range, maxValue );
+      continue;
+    }
+    const __m128 q = _mm_cvtepi32_ps( _mm_cvttps_epi32( t ) );
+    if ( Aligned ) _mm_store_ps( p, q );
+    else _mm_storeu_ps( p, q );
+  }
+  return i;
+}
+
+// same operations as the normal and color quantizeSse2 on packets of 8 values
+template <bool Aligned>
+MM_TARGET_AVX2 size_t quantizeAvx2( const size_t count,
+                                    float*       values,
+                                    const float  minValue,
+                                    const float  range,
+                                    const float  maxValue ) {
+  const __m256 offset = _mm256_set1_ps( minValue );
+  const __m256 div    = _mm256_set1_ps( range );
+  const __m256 mul    = _mm256_set1_ps( maxValue );
+  const __m256 half   = _mm256_set1_ps( 0.5f );
+  const __m256 zero   = _mm256_setzero_ps();
+  const __m256 limit  = _mm256_set1_ps( 2147483648.0f );
+  size_t       i      = 0;
+  for ( ; i + 8 <= count; i += 8 ) {
+    float*       p = values + i;
+    const __m256 v = Aligned ? _mm256_load_ps( p ) : _mm256_loadu_ps( p );
+    const __m256 t =
+      _mm256_add_ps( _mm256_mul_ps( _mm256_div_ps( _mm256_sub_ps( v, offset ), div ), mul ), half );
+    const __m256 in = _mm256_and_ps( _mm256_cmp_ps( t, zero, _CMP_GE_OQ ), _mm256_cmp_ps( t, limit, _CMP_LT_OQ ) );
+    if ( _mm256_movemask_ps( in ) != 255 ) {
+      for ( size_t k = 0; k < 8; ++k ) p[k] = quantizeScalar( p[k], minValue, range, maxValue );
+      continue;
+    }
+    const __m256 q = _mm256_cvtepi32_ps( _mm256_cvttps_epi32( t ) );
+    if ( Aligned ) _mm256_store_ps( p, q );
+    else _mm256_storeu_ps( p, q );
+  }
+  return i;
+}
+
+#endif
+
+// best instruction set supported by the cpu
+Geometry::SimdLevel detectSimdLevel() {
+#ifdef MM_SIMD_X86
+#if defined( _MSC_VER ) && !defined( __clang__ )
+  int info[4];
+  __cpuid( info, 0 );
+  const int maxLeaf = info[0];
+  __cpuid( info, 1 );
+  const bool sse2    = ( info[3] & ( 1 << 26 ) ) != 0;
+  const bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+  bool       avx2    = false;
+  // the os must also save the ymm registers
+  if ( maxLeaf >= 7 && osxsave && ( _xgetbv( 0 ) & 6 ) == 6 ) {
+    __cpuidex( info, 7, 0 );
+    avx2 = ( info[1] & ( 1 << 5 ) ) != 0;
+  }
+#else
+  __builtin_cpu_init();
+  const bool sse2 = __builtin_cpu_supports( "sse2" );
+  const bool avx2 = __builtin_cpu_supports( "avx2" );
+#endif
+  if ( avx2 ) return Geometry::SIMD_AVX2;
+  if ( sse2 ) return Geometry::SIMD_SSE2;
+#endif
+  return Geometry::SIMD_SCALAR;
+}
+
+Geometry::SimdLevel supportedSimdLevel() {
+  static const Geometry::SimdLevel level = detectSimdLevel();
+  return level;
+}
+
+Geometry::SimdLevel& currentSimdLevel() {
+  static Geometry::SimdLevel level = supportedSimdLevel();
+  return level;
+}
+
+}  // namespace
+
+Geometry::SimdLevel Geometry::getSimdLevel() { return currentSimdLevel(); }
+
+void Geometry::setSimdLevel( SimdLevel level ) { currentSimdLevel() = std::min( level, supportedSimdLevel() ); }
+
+size_t Geometry::evalRayTriangleBatch( const glm::vec3& rayDirection,
+                                       const size_t     count,
+                                       const float*     originX,
+                                       const float*     originY,
+                                       const float*     originZ,
+                                       const glm::vec3& v0,
+                                       const glm::vec3& v1,
+                                       const glm::vec3& v2,
+                                       float*           t,
+                                       float*           u,
+                                       float*           v,
+                                       uint8_t*         hits,
+                                       float            epsilon ) {
+  RayTriangleSetup s;
+  s.dir   = rayDirection;
+  s.v0    = v0;
+  s.edge1 = v1 - v0;
+  s.edge2 = v2 - v0;
+  s.pvec  = glm::cross( rayDirection, s.edge2 );
+
+  /* if determinant is near zero, rays lie in plane of triangle */
+  const float det = glm::dot( s.edge1, s.pvec );
+  if ( det > -epsilon && det < epsilon ) {
+    std::fill( hits, hits + count, 0 );
+    return 0;
+  }
+  s.inv_det = 1.0f / det;
+
+  size_t hitCount = 0;
+  size_t first    = 0;
+#ifdef MM_SIMD_X86
+  switch ( currentSimdLevel() ) {
+    case SIMD_AVX2: first = evalRayTriangleAvx2( s, count, originX, originY, originZ, t, u, v, hits, hitCount ); break;
+    case SIMD_SSE2: first = evalRayTriangleSse2( s, count, originX, originY, originZ, t, u, v, hits, hitCount ); break;
+    default: break;
+  }
+#endif
+  // remaining rays that do not fill a packet
+  return hitCount + evalRayTriangleScalar( s, first, count, originX, originY, originZ, t, u, v, hits );
+}
+
+// same operations as Model::computeFaceNormals. no packet version, the positions are fetched through
+// the indices and loading them into x, y, z registers costs more than the few products it saves.
+void Geometry::computeFaceNormalsBatch( const size_t count,
+                                        const float* positions,
+                                        const int*   triangles,
+                                        float*       normals ) {
+  for ( size_t i = 0; i < count; ++i ) {
+    const float*    p0 = &positions[(size_t)triangles[i * 3 + 0] * 3];
+    const float*    p1 = &positions[(size_t)triangles[i * 3 + 1] * 3];
+    const float*    p2 = &positions[(size_t)triangles[i * 3 + 2] * 3];
+    const glm::vec3 v0( p0[0], p0[1], p0[2] );
+    const glm::vec3 normal = glm::cross( glm::vec3( p1[0], p1[1], p1[2] ) - v0, glm::vec3( p2[0], p2[1], p2[2] ) - v0 );
+    for ( glm::vec3::length_type c = 0; c < 3; c++ ) normals[i * 3 + c] = normal[c];
+  }
+}
+
+void Geometry::normalizeBatch( const size_t count, float* vectors ) {
+  size_t first = 0;
+#ifdef MM_SIMD_X86
+  switch ( currentSimdLevel() ) {
+    case SIMD_AVX2: first = normalizeAvx2( count, vectors ); break;
+    case SIMD_SSE2: first = normalizeSse2( count, vectors ); break;
+    default: break;
+  }
+#endif
+  // remaining vectors that do not fill a packet
+  normalizeScalar( first, count, vectors );
+}
+
+void Geometry::computeBBox( const size_t count,
+                            const float* x,
+                            const float* y,
+                            const float* z,
+                            glm::vec3&   minPos,
+                            glm::vec3&   maxPos,
+                            bool         reset ) {
+  if ( reset ) {
+    minPos = { FLT_MAX, FLT_MAX, FLT_MAX };
+    maxPos = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+  }
+  const float* values[3] = { x, y, z };
+  for ( glm::vec3::length_type c = 0; c < 3; c++ ) {
+    const float minValue = minPos[c];
+    const float maxValue = maxPos[c];
+    size_t      first    = 0;
+#ifdef MM_SIMD_X86
+    // nan bounds are replaced by the first value by the scalar code, not by min and max
+    if ( !std::isnan( minValue ) && !std::isnan( maxValue ) ) {
+      switch ( currentSimdLevel() ) {
+        case SIMD_AVX2:
+          first = isAligned( values[c], 32 ) ? minMaxAvx2<true>( count, values[c], minPos[c], maxPos[c] )
+                                             : minMaxAvx2<false>( count, values[c], minPos[c], maxPos[c] );
+          break;
+        case SIMD_SSE2:
+          first = isAligned( values[c], 16 ) ? minMaxSse2<true>( count, values[c], minPos[c], maxPos[c] )
+                                             : minMaxSse2<false>( count, values[c], minPos[c], maxPos[c] );
+          break;
+        default: break;
+      }
+    }
+#endif
+    // remaining values that do not fill a packet
+    minMaxScalar( first, count, values[c], minPos[c], maxPos[c] );
+    if ( first != 0 ) {
+      minPos[c] = zeroBound( minPos[c], minValue, count, values[c] );
+      maxPos[c] = zeroBound( maxPos[c], maxValue, count, values[c] );
+    }
+  }
+}
+
+void Geometry::quantizeBatch( const size_t count, float* values, const float minValue, const double scale ) {
+  size_t first = 0;
+#ifdef MM_SIMD_X86
+  switch ( currentSimdLevel() ) {
+    case SIMD_AVX2:
+      first = isAligned( values, 32 ) ? quantizeAvx2<true>( count, values, minValue, scale )
+                                      : quantizeAvx2<false>( count, values, minValue, scale );
+      break;
+    case SIMD_SSE2:
+      first = isAligned( values, 16 ) ? quantizeSse2<true>( count, values, minValue, scale )
+                                      : quantizeSse2<false>( count, values, minValue, scale );
+      break;
+    default: break;
+  }
+#endif
+  // remaining values that do not fill a packet
+  for ( size_t i = first; i < count; ++i ) values[i] = quantizeScalar( values[i], minValue, scale );
+}
+
+void Geometry::quantizeBatch( const size_t count,
+                              float*       values,
+                              const float  minValue,
+                              const float  range,
+                              const float  maxValue ) {
+  size_t first = 0;
+#ifdef MM_SIMD_X86
+  switch ( currentSimdLevel() ) {
+    case SIMD_AVX2:
+      first = isAligned( values, 32 ) ? quantizeAvx2<true>( count, values, minValue, range, maxValue )
+                                      : quantizeAvx2<false>( count, values, minValue, range, maxValue );
+      break;
+    case SIMD_SSE2:
+      first = isAligned( values, 16 ) ? quantizeSse2<true>( count, values, minValue, range, maxValue )
+                                      : quantizeSse2<false>( count, values, minValue, range, maxValue );
+      break;
+    default: break;
+  }
+#endif
+  // remaining values that do not fill a packet
+  for ( size_t i = first; i < count; ++i ) values[i] = quantizeScalar( values[i], minValue, range, maxValue );
+}
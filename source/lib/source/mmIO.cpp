@@ -26,7 +26,31 @@
 #include <fstream>
 #include <unordered_map>
 #include <time.h>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <filesystem>
+#ifdef OPENMP_FOUND
+#  include <omp.h>
+#endif
+// memory mapped files
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
 // ply loader
 #define TINYPLY_IMPLEMENTATION
 #include "tinyply.h"
@@ -41,67 +65,143 @@
 #include <glm/gtx/string_cast.hpp>
 
 #include "mmIO.h"
+#include "mmCache.h"
 
 using namespace mm;
 
 //
 Context* IO::_context = NULL;
 // create the stores
-std::map<std::string, Model*> IO::_models;
-std::map<std::string, Image*> IO::_images;
+thread_local std::map<std::string, std::shared_ptr<Model>> IO::_models;
+thread_local std::map<std::string, std::shared_ptr<Image>> IO::_images;
+thread_local std::map<std::string, size_t>                 IO::_uses;
+thread_local std::ostream*                                 IO::_log      = NULL;
+thread_local std::ostream*                                 IO::_errorLog = NULL;
+// prefetched models and images
+std::map<std::pair<uint32_t, std::string>, IO::Prefetch<Model>> IO::_prefetchedModels;
+std::map<std::pair<uint32_t, std::string>, IO::Prefetch<Image>> IO::_prefetchedImages;
+size_t                                                          IO::_prefetchedBytes = 0;
 
 //
 void IO::setContext( Context* context ) { _context = context; }
 
+//
+std::ostream& IO::log( void ) { return _log != NULL ? *_log : std::cout; }
+
+//
+std::ostream& IO::errorLog( void ) { return _errorLog != NULL ? *_errorLog : std::cerr; }
+
+//
+template <typename T>
+std::future<T*> IO::launch( T* ( *load )( const std::string& ),
+                            const std::string&           name,
+                            std::shared_ptr<std::string> log ) {
+  return std::async( std::launch::async, [load, name, log]() {
+    std::ostringstream buffer;
+    _log      = &buffer;
+    _errorLog = &buffer;
+    T* result = load( name );
+    _log      = NULL;
+    _errorLog = NULL;
+    *log      = buffer.str();
+    return result;
+  } );
+}
+
 //
 std::string IO::resolveName( const uint32_t frame, const std::string& input ) {
+  std::string output = resolve( frame, input );
+  if ( input.find( "%" ) != std::string::npos ) { std::cout << output << std::endl; }
+  return output;
+}
+
+//
+std::string IO::resolve( const uint32_t frame, const std::string& input ) {
   std::string output;
   if ( input.find( "%" ) != std::string::npos ) {
     char buffer[4092];
     auto n = sprintf( buffer, input.c_str(), frame );
     output = buffer;
-    std::cout << output << std::endl;
   } else {
     output = input;
   }
   return output;
 }
 
+// loads a model file, through the on-disk cache if enabled, returns NULL on error
+static Model* loadModelFile( const std::string& name ) {
+  Model*     model    = new Model();
+  const bool useCache = Cache::enabled() && name.size() >= 4 && name.substr( name.size() - 4 ) != ".mmb";
+  if ( useCache && Cache::load( name, *model ) ) {
+    IO::log() << "Loading file: " << name << " (from cache)" << std::endl;
+    return model;
+  }
+  if ( !IO::_loadModel( name, *model ) ) {
+    delete model;
+    return NULL;
+  }
+  if ( useCache ) Cache::store( name, *model );
+  return model;
+}
+
+// loads an image file, videos are not handled, returns NULL on error
+static Image* loadImageFile( const std::string& name ) {
+  Image* image = new Image();
+  if ( !IO::_loadImage( name, *image ) ) {
+    delete image;
+    return NULL;
+  }
+  return image;
+}
+
+// returns the video files extensions, frames of videos are read using the context frame
+static bool isVideo( const std::string& name ) {
+  const size_t pos = name.find_last_of( "." );
+  if ( pos == std::string::npos ) return false;
+  std::string ext = name.substr( pos );
+  std::transform( ext.begin(), ext.end(), ext.begin(), []( unsigned char c ) { return std::tolower( c ); } );
+  return ext == ".yuv" || ext == ".rgb";
+}
+
 //
 Model* IO::loadModel( std::string templateName ) {
-  std::string                             name = resolveName( _context->getFrame(), templateName );
-  std::map<std::string, Model*>::iterator it   = IO::_models.find( name );
+  std::string name = resolveName( _context->getFrame(), templateName );
+  auto        it   = IO::_models.find( name );
   if ( it == IO::_models.end() ) {
     if ( name.substr( 0, 3 ) == "ID:" ) {
       std::cout << "Error: model with id " << name << "not defined" << std::endl;
       return NULL;
-    } else {  // we try to load the model
-      Model* model = new Model();
-      if ( !IO::_loadModel( name, *model ) ) {
-        delete model;
-        return NULL;
-      } else {
-        IO::_models[name] = model;
-        return model;
-      }
     }
+    // use the model loaded in background if any
+    Model* model = NULL;
+    auto   pit   = _prefetchedModels.find( std::make_pair( _context->getFrame(), name ) );
+    if ( pit != _prefetchedModels.end() ) {
+      model = pit->second.result.get();
+      if ( model != NULL ) std::cout << *pit->second.log;
+      _prefetchedBytes -= pit->second.bytes;
+      _prefetchedModels.erase( pit );
+    }
+    // else (or on background error, to report it) we try to load the model
+    if ( model == NULL && ( model = loadModelFile( name ) ) == NULL ) { return NULL; }
+    IO::_models[name].reset( model );
+    return model;
   }
-  return it->second;
+  return it->second.get();
 };
 
 //
-bool IO::saveModel( std::string templateName, Model* model ) {
-  std::string                             name = resolveName( _context->getFrame(), templateName );
-  std::map<std::string, Model*>::iterator it   = IO::_models.find( name );
+bool IO::saveModel( std::string templateName, Model* model, bool binaryPly ) {
+  std::string name = resolveName( _context->getFrame(), templateName );
+  auto        it   = IO::_models.find( name );
   if ( it != IO::_models.end() ) {
     std::cout << "Warning: model with id " << name << " already defined, overwriting" << std::endl;
-    delete it->second;
-    it->second = model;
+    // the store takes ownership, unless the model is the stored one
+    if ( it->second.get() != model ) { it->second.reset( model ); }
   } else {
-    IO::_models[name] = model;
+    IO::_models[name].reset( model );
   }
   // save to file if not an id
-  if ( name.substr( 0, 3 ) != "ID:" ) { return IO::_saveModel( name, *model ); }
+  if ( name.substr( 0, 3 ) != "ID:" ) { return IO::_saveModel( name, *model, binaryPly ); }
   return true;
 }
 
@@ -109,11 +209,11 @@ bool IO::saveModel( std::string templateName, Model* model ) {
 Image* IO::loadImage( std::string templateName ) {
   // The IO store is purged for each new frame.
   // So in case of video file without %d template we just use the filename (unchanged by resolveName).
-  std::string                             name = resolveName( _context->getFrame(), templateName );
-  std::map<std::string, Image*>::iterator it   = IO::_images.find( name );
+  std::string name = resolveName( _context->getFrame(), templateName );
+  auto        it   = IO::_images.find( name );
 
   // use image/frame from store
-  if ( it != IO::_images.end() ) { return it->second; }
+  if ( it != IO::_images.end() ) { return it->second.get(); }
 
   // not found in store but name is an ID => error
   if ( name.substr( 0, 3 ) == "ID:" ) {
@@ -121,6 +221,19 @@ Image* IO::loadImage( std::string templateName ) {
     return NULL;
   }
 
+  // use the image loaded in background if any
+  auto pit = _prefetchedImages.find( std::make_pair( _context->getFrame(), name ) );
+  if ( pit != _prefetchedImages.end() ) {
+    Image* image = pit->second.result.get();
+    _prefetchedBytes -= pit->second.bytes;
+    if ( image != NULL ) std::cout << *pit->second.log;
+    _prefetchedImages.erase( pit );
+    if ( image != NULL ) {
+      IO::_images[name].reset( image );
+      return image;
+    }
+  }
+
   // else try to load the image/frame
   Image* image = new Image();
 
@@ -141,7 +254,7 @@ Image* IO::loadImage( std::string templateName ) {
     }
   }
   // add to the store
-  IO::_images[name] = image;
+  IO::_images[name].reset( image );
   return image;
 };
 
@@ -162,28 +275,137 @@ bool  IO::saveImage(std::string name, Image* image) {
         }
 }*/
 
+//
+void IO::setUses( const std::vector<std::string>& inputTemplates ) {
+  _uses.clear();
+  for ( auto& input : inputTemplates ) {
+    if ( !input.empty() ) { ++_uses[resolve( _context->getFrame(), input )]; }
+  }
+}
+
+//
+void IO::release( const std::vector<std::string>& inputTemplates, const std::vector<std::string>& outputTemplates ) {
+  const uint32_t           frame = _context->getFrame();
+  std::vector<std::string> names;
+  for ( auto& input : inputTemplates ) {
+    if ( input.empty() ) continue;
+    names.push_back( resolve( frame, input ) );
+    auto it = _uses.find( names.back() );
+    if ( it != _uses.end() && it->second > 0 ) { --it->second; }
+  }
+  for ( auto& output : outputTemplates ) {
+    if ( !output.empty() ) { names.push_back( resolve( frame, output ) ); }
+  }
+  // free what no other command of the frame will read
+  for ( auto& name : names ) {
+    auto it = _uses.find( name );
+    if ( it != _uses.end() && it->second > 0 ) continue;
+    _models.erase( name );
+    _images.erase( name );
+    _uses.erase( name );
+  }
+}
+
+//
+bool IO::isMovable( std::string templateName ) {
+  const std::string name = resolve( _context->getFrame(), templateName );
+  if ( name.substr( 0, 3 ) != "ID:" ) return false;
+  auto it = _uses.find( name );
+  return it != _uses.end() && it->second == 1;
+}
+
 //
 void IO::purge( void ) {
-  // free all the texture maps
-  std::map<std::string, Image*>::iterator imageIt = IO::_images.begin();
-  for ( ; imageIt != _images.end(); ++imageIt ) { delete imageIt->second; }
+  // free all the texture maps and models of the thread
   _images.clear();
-
-  // free all the models
-  std::map<std::string, Model*>::iterator modelIt = IO::_models.begin();
-  for ( ; modelIt != _models.end(); ++modelIt ) { delete modelIt->second; }
   _models.clear();
+  _uses.clear();
+
+  // free the prefetched models and images of current and previous frames that were not used
+  const uint32_t frame = _context != NULL ? _context->getFrame() : 0;
+  for ( auto pit = _prefetchedModels.begin(); pit != _prefetchedModels.end() && pit->first.first <= frame; ) {
+    delete pit->second.result.get();
+    _prefetchedBytes -= pit->second.bytes;
+    pit = _prefetchedModels.erase( pit );
+  }
+  for ( auto pit = _prefetchedImages.begin(); pit != _prefetchedImages.end() && pit->first.first <= frame; ) {
+    delete pit->second.result.get();
+    _prefetchedBytes -= pit->second.bytes;
+    pit = _prefetchedImages.erase( pit );
+  }
+}
+
+//
+void IO::prefetch( const uint32_t                  frame,
+                   const std::vector<std::string>& modelTemplates,
+                   const std::vector<std::string>& imageTemplates,
+                   const size_t                    maxLoads,
+                   const size_t                    memoryLimit ) {
+  // number of loads in progress
+  size_t loads = 0;
+  auto   count = [&]( const auto& prefetched ) {
+    for ( const auto& it : prefetched ) {
+      if ( it.second.result.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready ) ++loads;
+    }
+  };
+  count( _prefetchedModels );
+  count( _prefetchedImages );
+  // returns the size of the file to prefetch, 0 if it shall not be prefetched
+  auto fileSize = [&]( const std::string& name ) -> size_t {
+    if ( name.substr( 0, 3 ) == "ID:" || isVideo( name ) || loads >= maxLoads ) return 0;
+    std::error_code ec;
+    const uintmax_t size = std::filesystem::file_size( name, ec );
+    if ( ec || _prefetchedBytes + (size_t)size > memoryLimit ) return 0;
+    return (size_t)size;
+  };
+  for ( const auto& templateName : modelTemplates ) {
+    const auto key = std::make_pair( frame, resolveName( frame, templateName ) );
+    if ( _prefetchedModels.find( key ) != _prefetchedModels.end() ) continue;
+    const size_t bytes = fileSize( key.second );
+    if ( bytes == 0 ) continue;
+    _prefetchedBytes += bytes;
+    ++loads;
+    auto log               = std::make_shared<std::string>();
+    _prefetchedModels[key] = { bytes, launch( loadModelFile, key.second, log ), log };
+  }
+  for ( const auto& templateName : imageTemplates ) {
+    const auto key = std::make_pair( frame, resolveName( frame, templateName ) );
+    if ( _prefetchedImages.find( key ) != _prefetchedImages.end() ) continue;
+    const size_t bytes = fileSize( key.second );
+    if ( bytes == 0 ) continue;
+    _prefetchedBytes += bytes;
+    ++loads;
+    auto log               = std::make_shared<std::string>();
+    _prefetchedImages[key] = { bytes, launch( loadImageFile, key.second, log ), log };
+  }
 }
 
 ///////////////////////////
 // Private methods
 
+// prints the loading time and the parse throughput in MB/s, measured on wall clock since clock()
+// would count the cpu time of all the threads of the process
+static void printLoadingTime( const std::string& filename, std::chrono::steady_clock::time_point t1 ) {
+  const double  seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - t1 ).count();
+  std::ifstream fin( filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate );
+  const double  mb = fin ? (double)fin.tellg() / ( 1024.0 * 1024.0 ) : 0.0;
+  IO::log() << "Time on loading: " << (float)seconds << " sec.";
+  if ( seconds > 0 ) IO::log() << " (" << (float)( mb / seconds ) << " MB/s)";
+  IO::log() << std::endl;
+}
+
+// prints the saving time measured on wall clock
+static void printSavingTime( std::chrono::steady_clock::time_point t1 ) {
+  const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - t1 ).count();
+  std::cout << "Time on saving: " << (float)seconds << " sec." << std::endl;
+}
+
 bool IO::_loadModel( std::string filename, Model& output ) {
   bool success = true;
 
   // sanity check
   if ( filename.size() < 5 ) {
-    std::cout << "Error, invalid mesh file name " << filename << std::endl;
+    IO::log() << "Error, invalid mesh file name " << filename << std::endl;
     return false;
   }
 
@@ -193,41 +415,40 @@ bool IO::_loadModel( std::string filename, Model& output ) {
 
   // do the job
   if ( ext == "ply" ) {
-    std::cout << "Loading file: " << filename << std::endl;
-    auto t1 = clock();
+    IO::log() << "Loading file: " << filename << std::endl;
+    auto t1 = std::chrono::steady_clock::now();
     success = IO::_loadPly( filename, output );  // TODO handle read error
-    if ( success ) {
-      auto t2 = clock();
-      std::cout << "Time on loading: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
-    }
+    if ( success ) { printLoadingTime( filename, t1 ); }
   } else if ( ext == "obj" ) {
-    std::cout << "Loading file: " << filename << std::endl;
-    auto t1 = clock();
+    IO::log() << "Loading file: " << filename << std::endl;
+    auto t1 = std::chrono::steady_clock::now();
     success = IO::_loadObj( filename, output );  // TODO handle read error
-    if ( success ) {
-      auto t2 = clock();
-      std::cout << "Time on loading: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
-    }
+    if ( success ) { printLoadingTime( filename, t1 ); }
+  } else if ( ext == "mmb" ) {
+    IO::log() << "Loading file: " << filename << std::endl;
+    auto t1 = std::chrono::steady_clock::now();
+    success = IO::_loadMmb( filename, output );
+    if ( success ) { printLoadingTime( filename, t1 ); }
   } else {
-    std::cout << "Error, invalid mesh file extension (not in obj, ply)" << std::endl;
+    IO::log() << "Error, invalid mesh file extension (not in obj, ply, mmb)" << std::endl;
     return false;
   }
 
   if ( success ) {
     // print stats
-    std::cout << "Input model: " << filename << std::endl;
-    std::cout << "  Vertices: " << output.vertices.size() / 3 << std::endl;
-    std::cout << "  UVs: " << output.uvcoords.size() / 2 << std::endl;
-    std::cout << "  Colors: " << output.colors.size() / 3 << std::endl;
-    std::cout << "  Normals: " << output.normals.size() / 3 << std::endl;
-    std::cout << "  Triangles: " << output.triangles.size() / 3 << std::endl;
-    std::cout << "  Trianglesuv: " << output.trianglesuv.size() / 3 << std::endl;
+    IO::log() << "Input model: " << filename << std::endl;
+    IO::log() << "  Vertices: " << output.vertices.size() / 3 << std::endl;
+    IO::log() << "  UVs: " << output.uvcoords.size() / 2 << std::endl;
+    IO::log() << "  Colors: " << output.colors.size() / 3 << std::endl;
+    IO::log() << "  Normals: " << output.normals.size() / 3 << std::endl;
+    IO::log() << "  Triangles: " << output.triangles.size() / 3 << std::endl;
+    IO::log() << "  Trianglesuv: " << output.trianglesuv.size() / 3 << std::endl;
   }
 
   return success;
 }
 
-bool IO::_saveModel( std::string filename, const Model& input ) {
+bool IO::_saveModel( std::string filename, const Model& input, bool binaryPly ) {
   // sanity check
   if ( filename.size() < 5 ) {
     std::cout << "Error, invalid mesh file name " << filename << std::endl;
@@ -241,24 +462,24 @@ bool IO::_saveModel( std::string filename, const Model& input ) {
   // write output
   if ( out_ext == "ply" ) {
     std::cout << "Saving file: " << filename << std::endl;
-    auto t1  = clock();
-    auto err = IO::_savePly( filename, input );
-    if ( !err ) {
-      auto t2 = clock();
-      std::cout << "Time on saving: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
-    }
+    auto t1  = std::chrono::steady_clock::now();
+    auto err = IO::_savePly( filename, input, binaryPly );
+    if ( !err ) { printSavingTime( t1 ); }
     return err;
   } else if ( out_ext == "obj" ) {
     std::cout << "Saving file: " << filename << std::endl;
-    auto t1  = clock();
+    auto t1  = std::chrono::steady_clock::now();
     auto err = IO::_saveObj( filename, input );
-    if ( !err ) {
-      auto t2 = clock();
-      std::cout << "Time on saving: " << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec." << std::endl;
-    }
+    if ( !err ) { printSavingTime( t1 ); }
+    return err;
+  } else if ( out_ext == "mmb" ) {
+    std::cout << "Saving file: " << filename << std::endl;
+    auto t1  = std::chrono::steady_clock::now();
+    auto err = IO::_saveMmb( filename, input );
+    if ( !err ) { printSavingTime( t1 ); }
     return err;
   } else {
-    std::cout << "Error: invalid mesh file extension (not in obj, ply)" << std::endl;
+    std::cout << "Error: invalid mesh file extension (not in obj, ply, mmb)" << std::endl;
     return false;
   }
 
@@ -266,69 +487,396 @@ bool IO::_saveModel( std::string filename, const Model& input ) {
   return true;
 }
 
-bool IO::_loadObj( std::string filename, Model& output ) {
-  std::ifstream fin;
-  // use a big 4MB buffer to accelerate reads
-  char* buf = new char[4 * 1024 * 1024 + 1];
-  fin.rdbuf()->pubsetbuf( buf, 4 * 1024 * 1024 + 1 );
-  fin.open( filename.c_str(), std::ios::in );
-  if ( !fin ) {
-    std::cerr << "Error: can't open file " << filename << std::endl;
-    delete[] buf;
-    return false;
+// Read only view on the full content of a file. Uses the system memory mapping
+// when available and falls back to a plain read into memory otherwise.
+class MappedFile {
+ public:
+  MappedFile() {}
+  ~MappedFile() { close(); }
+
+  bool open( const std::string& filename ) {
+    close();
+#ifdef _WIN32
+    _file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    if ( _file == INVALID_HANDLE_VALUE ) return false;
+    LARGE_INTEGER size;
+    if ( !GetFileSizeEx( _file, &size ) ) {
+      close();
+      return false;
+    }
+    _size = (size_t)size.QuadPart;
+    if ( _size == 0 ) return true;
+    _mapping = CreateFileMappingA( _file, NULL, PAGE_READONLY, 0, 0, NULL );
+    if ( _mapping != NULL ) _data = (const char*)MapViewOfFile( _mapping, FILE_MAP_READ, 0, 0, 0 );
+#else
+    _fd = ::open( filename.c_str(), O_RDONLY );
+    if ( _fd < 0 ) return false;
+    struct stat st;
+    if ( fstat( _fd, &st ) != 0 ) {
+      close();
+      return false;
+    }
+    _size = (size_t)st.st_size;
+    if ( _size == 0 ) return true;
+    void* addr = mmap( NULL, _size, PROT_READ, MAP_PRIVATE, _fd, 0 );
+    if ( addr != MAP_FAILED ) {
+      _mapped = true;
+      _data   = (const char*)addr;
+#  ifdef MADV_SEQUENTIAL
+      madvise( addr, _size, MADV_SEQUENTIAL );
+#  endif
+    }
+#endif
+    if ( _data == NULL ) {
+      // mapping not possible, read the file the classic way
+      std::ifstream fin( filename.c_str(), std::ios::in | std::ios::binary );
+      _buffer.resize( _size );
+      if ( !fin || !fin.read( _buffer.data(), _size ) ) {
+        close();
+        return false;
+      }
+      _data = _buffer.data();
+    }
+    return true;
+  }
+
+  void close( void ) {
+#ifdef _WIN32
+    if ( _data != NULL && _buffer.empty() ) UnmapViewOfFile( _data );
+    if ( _mapping != NULL ) CloseHandle( _mapping );
+    if ( _file != INVALID_HANDLE_VALUE ) CloseHandle( _file );
+    _mapping = NULL;
+    _file    = INVALID_HANDLE_VALUE;
+#else
+    if ( _mapped ) munmap( (void*)_data, _size );
+    if ( _fd >= 0 ) ::close( _fd );
+    _mapped = false;
+    _fd     = -1;
+#endif
+    _buffer.clear();
+    _data = NULL;
+    _size = 0;
+  }
+
+  const char* data( void ) const { return _data; }
+  size_t      size( void ) const { return _size; }
+
+ private:
+  const char*       _data = NULL;
+  size_t            _size = 0;
+  std::vector<char> _buffer;  // used when mapping failed
+#ifdef _WIN32
+  HANDLE _file    = INVALID_HANDLE_VALUE;
+  HANDLE _mapping = NULL;
+#else
+  int  _fd     = -1;
+  bool _mapped = false;
+#endif
+};
+
+// Cursor on one line of text. Mimics the behavior of the std::istringstream
+// extraction operators used by the original OBJ parser: once an extraction
+// fails, all subsequent extractions on the line fail and leave their output untouched.
+struct LineReader {
+  const char* p;
+  const char* end;
+  bool        good;
+
+  LineReader( const char* begin, const char* last ) : p( begin ), end( last ), good( true ) {}
+
+  static inline bool isSpace( char c ) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
   }
-  int         temp_index;
-  float       temp_pos, temp_uv, temp_normal, temp_col;
-  std::string temp_flag, temp_str;
-  std::string line;
-  std::getline( fin, line );
-  while ( fin ) {
-    std::istringstream in( line );
-    temp_flag = "";
-    in >> temp_flag;  // temp_flag: the first word in the line
-    if ( temp_flag.compare( std::string( "mtllib" ) ) == 0 ) {
-      output.header = std::string( line.c_str() );
-    } else if ( temp_flag.compare( std::string( "v" ) ) == 0 ) {
+  static inline bool isDigit( char c ) { return c >= '0' && c <= '9'; }
+
+  // returns false if no more characters on the line
+  inline bool skipSpaces( void ) {
+    while ( p < end && isSpace( *p ) ) ++p;
+    if ( p == end ) good = false;
+    return good;
+  }
+
+  // equivalent of "in >> str", [begin, last) is left unchanged on failure
+  inline bool token( const char*& begin, const char*& last ) {
+    if ( !good || !skipSpaces() ) return false;
+    begin = p;
+    while ( p < end && !isSpace( *p ) ) ++p;
+    last = p;
+    return true;
+  }
+
+  // equivalent of "in >> value" for a float, value is left unchanged on failure.
+  // Numbers are converted with a fast exact path and std::strtof otherwise,
+  // so that results are the same as the ones of the C++ stream.
+  inline bool number( float& value ) {
+    static const float pow10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+    if ( !good || !skipSpaces() ) return false;
+    const char* start     = p;
+    bool        negative  = false;
+    uint64_t    mantissa  = 0;
+    int         digits    = 0;
+    int         exponent  = 0;
+    bool        hasDigits = false;
+    bool        exact     = true;
+    if ( *p == '+' || *p == '-' ) {
+      negative = *p == '-';
+      ++p;
+    }
+    for ( ; p < end && isDigit( *p ); ++p ) {
+      hasDigits = true;
+      if ( mantissa == 0 && *p == '0' ) continue;
+      if ( digits++ < 19 ) mantissa = mantissa * 10 + ( *p - '0' );
+      else exact = false;
+    }
+    if ( p < end && *p == '.' ) {
+      for ( ++p; p < end && isDigit( *p ); ++p ) {
+        hasDigits = true;
+        if ( mantissa == 0 && *p == '0' ) {
+          --exponent;
+          continue;
+        }
+        if ( digits++ < 19 ) {
+          mantissa = mantissa * 10 + ( *p - '0' );
+          --exponent;
+        } else exact = false;
+      }
+    }
+    if ( hasDigits && p < end && ( *p == 'e' || *p == 'E' ) ) {
+      ++p;
+      bool expNegative = false;
+      if ( p < end && ( *p == '+' || *p == '-' ) ) {
+        expNegative = *p == '-';
+        ++p;
+      }
+      int  expValue  = 0;
+      bool expDigits = false;
+      for ( ; p < end && isDigit( *p ); ++p ) {
+        expDigits = true;
+        if ( expValue < 100000 ) expValue = expValue * 10 + ( *p - '0' );
+      }
+      if ( !expDigits ) exact = false;
+      exponent += expNegative ? -expValue : expValue;
+    }
+    if ( !hasDigits ) exact = false;
+    if ( exact && mantissa == 0 ) {
+      value = negative ? -0.0f : 0.0f;
+      return true;
+    }
+    // both operands are exact floats (10^10 = 2^10 * 5^10 with 5^10 < 2^24), so the single
+    // division or multiplication is correctly rounded, as strtof. going through double would
+    // round twice and differ from strtof on long mantissas.
+    if ( exact && mantissa < ( 1ull << 24 ) && exponent >= -10 && exponent <= 10 ) {
+      const float res = exponent < 0 ? (float)mantissa / pow10[-exponent] : (float)mantissa * pow10[exponent];
+      value           = negative ? -res : res;
+      return true;
+    }
+    // slow path, use the C library on the same characters the stream would have consumed
+    std::string str( start, p );
+    char*       last = NULL;
+    float       res  = std::strtof( str.c_str(), &last );
+    if ( str.empty() || last != str.c_str() + str.size() ) {
+      value = 0.0f;
+      good  = false;
+    } else if ( res == HUGE_VALF || res == -HUGE_VALF ) {
+      value = res > 0 ? std::numeric_limits<float>::max() : -std::numeric_limits<float>::max();
+      good  = false;
+    } else {
+      value = res;
+    }
+    return good;
+  }
+
+  // equivalent of atoi on [begin, last)
+  static inline int toInt( const char* begin, const char* last ) {
+    bool    negative = false;
+    int64_t res      = 0;
+    if ( begin < last && ( *begin == '+' || *begin == '-' ) ) {
+      negative = *begin == '-';
+      ++begin;
+    }
+    for ( ; begin < last && isDigit( *begin ); ++begin ) res = res * 10 + ( *begin - '0' );
+    return (int)( negative ? -res : res );
+  }
+};
+
+// returns true if the line starts with the given keyword
+static inline bool startsWith( const char* begin, const char* last, const char* keyword, size_t length ) {
+  while ( begin < last && LineReader::isSpace( *begin ) ) ++begin;
+  return (size_t)( last - begin ) >= length && std::memcmp( begin, keyword, length ) == 0 &&
+         ( (size_t)( last - begin ) == length || LineReader::isSpace( begin[length] ) );
+}
+
+// Values that the OBJ parser carries from one line to the next. Only malformed
+// lines (missing numbers or indices) make use of the values set by previous lines.
+struct ObjParserState {
+  float       temp_pos = 0.0f, temp_uv = 0.0f, temp_normal = 0.0f, temp_col = 0.0f;
+  const char* temp_str     = NULL;
+  const char* temp_str_end = NULL;
+  // set to true if a malformed line reused a value from a previous line
+  bool carried = false;
+};
+
+// Parses the lines of [data, end) and appends the result to output.
+static void parseObj( const char* data, const char* end, Model& output, ObjParserState& state ) {
+  // first quick pass to count the elements and reserve the memory
+  size_t vertexCount = 0, normalCount = 0, uvCount = 0, faceCount = 0;
+  bool   hasColors = false;
+  for ( const char* line = data; line < end; ) {
+    const char* next = (const char*)std::memchr( line, '\n', end - line );
+    if ( next == NULL ) next = end;
+    if ( startsWith( line, next, "v", 1 ) ) {
+      if ( vertexCount++ == 0 ) {
+        LineReader in( line, next );
+        const char *begin, *last;
+        int         count = 0;
+        while ( in.token( begin, last ) ) ++count;
+        hasColors = count > 4;
+      }
+    } else if ( startsWith( line, next, "f", 1 ) ) ++faceCount;
+    else if ( startsWith( line, next, "vt", 2 ) ) ++uvCount;
+    else if ( startsWith( line, next, "vn", 2 ) ) ++normalCount;
+    line = next + 1;
+  }
+  output.vertices.reserve( output.vertices.size() + 3 * vertexCount );
+  output.normals.reserve( output.normals.size() + 3 * normalCount );
+  output.uvcoords.reserve( output.uvcoords.size() + 2 * uvCount );
+  output.triangles.reserve( output.triangles.size() + 3 * faceCount );
+  if ( hasColors ) output.colors.reserve( output.colors.size() + 3 * vertexCount );
+  if ( uvCount != 0 ) output.trianglesuv.reserve( output.trianglesuv.size() + 3 * faceCount );
+
+  // parse the lines
+  for ( const char* line = data; line < end; ) {
+    const char* next = (const char*)std::memchr( line, '\n', end - line );
+    if ( next == NULL ) next = end;
+    LineReader  in( line, next );
+    const char *flag = line, *flag_end = line;
+    in.token( flag, flag_end );  // flag: the first word in the line
+    const size_t flagSize = flag_end - flag;
+    if ( flagSize == 1 && flag[0] == 'v' ) {
       // parse the position
       for ( int i = 0; i < 3; i++ ) {
-        in >> temp_pos;
-        output.vertices.push_back( temp_pos );
+        if ( !in.number( state.temp_pos ) ) state.carried = true;
+        output.vertices.push_back( state.temp_pos );
       }
       // parse the color if any (re map 0.0-1.0 to 0-255 internal color format)
-      while ( in >> temp_col ) { output.colors.push_back( std::roundf( temp_col * 255 ) ); }
-    } else if ( temp_flag.compare( std::string( "vn" ) ) == 0 ) {
+      while ( in.number( state.temp_col ) ) { output.colors.push_back( std::roundf( state.temp_col * 255 ) ); }
+    } else if ( flagSize == 2 && flag[0] == 'v' && flag[1] == 'n' ) {
       for ( int i = 0; i < 3; i++ ) {
-        in >> temp_normal;
-        output.normals.push_back( temp_normal );
+        if ( !in.number( state.temp_normal ) ) state.carried = true;
+        output.normals.push_back( state.temp_normal );
       }
-    } else if ( temp_flag.compare( std::string( "vt" ) ) == 0 ) {
+    } else if ( flagSize == 2 && flag[0] == 'v' && flag[1] == 't' ) {
       for ( int i = 0; i < 2; i++ ) {
-        in >> temp_uv;
-        output.uvcoords.push_back( temp_uv );
+        if ( !in.number( state.temp_uv ) ) state.carried = true;
+        output.uvcoords.push_back( state.temp_uv );
       }
-    } else if ( temp_flag.compare( std::string( "f" ) ) == 0 ) {
+    } else if ( flagSize == 1 && flag[0] == 'f' ) {
       for ( int i = 0; i < 3; i++ ) {
-        in >> temp_str;
-        size_t found;
-
+        if ( !in.token( state.temp_str, state.temp_str_end ) ) state.carried = true;
+        const char* str     = state.temp_str;
+        const char* str_end = state.temp_str_end;
         // parsing of texture coord indexes
         // TODO parsing of normals indexes and reindex
-        found = temp_str.find_first_of( "/" );
-        if ( found != std::string::npos ) {
-          temp_index   = atoi( temp_str.substr( 0, found ).c_str() ) - 1;
-          int uv_index = atoi( temp_str.substr( found + 1, temp_str.size() - found ).c_str() ) - 1;
-          output.trianglesuv.push_back( uv_index );
-        } else temp_index = atoi( temp_str.c_str() ) - 1;
+        const char* found = str != NULL ? (const char*)std::memchr( str, '/', str_end - str ) : NULL;
+        int         temp_index;
+        if ( found != NULL ) {
+          temp_index = LineReader::toInt( str, found ) - 1;
+          output.trianglesuv.push_back( LineReader::toInt( found + 1, str_end ) - 1 );
+        } else temp_index = LineReader::toInt( str, str_end ) - 1;
         output.triangles.push_back( temp_index );
       }
+    } else if ( flagSize == 6 && std::memcmp( flag, "mtllib", 6 ) == 0 ) {
+      output.header = std::string( line, next );
+#ifdef _WIN32
+      // text mode reading used to remove the carriage returns
+      if ( !output.header.empty() && output.header.back() == '\r' ) output.header.pop_back();
+#endif
     }
-    std::getline( fin, line );
+    line = next + 1;
+  }
+}
+
+// appends src to dst starting at index offset of dst, dst must be already resized
+template <typename T>
+static inline void copyAt( const std::vector<T>& src, std::vector<T>& dst, size_t offset ) {
+  if ( !src.empty() ) std::memcpy( dst.data() + offset, src.data(), src.size() * sizeof( T ) );
+}
+
+bool IO::_loadObj( std::string filename, Model& output ) {
+  MappedFile file;
+  if ( !file.open( filename ) ) {
+    IO::errorLog() << "Error: can't open file " << filename << std::endl;
+    return false;
+  }
+  const char* data = file.data();
+  const char* end  = data + file.size();
+
+  // split the file in chunks made of full lines to be parsed concurrently.
+  // Small files are not worth the extra copy of the stitching.
+  int chunkCount = 1;
+#ifdef OPENMP_FOUND
+  const size_t minChunkSize = 1024 * 1024;
+  chunkCount = (int)std::max( (size_t)1, std::min( (size_t)omp_get_max_threads(), file.size() / minChunkSize ) );
+#endif
+  bool parsed = false;
+  if ( chunkCount > 1 ) {
+    std::vector<const char*> bounds( chunkCount + 1, end );
+    bounds[0] = data;
+    for ( int i = 1; i < chunkCount; ++i ) {
+      const char* pos = std::max( bounds[i - 1], data + ( file.size() / chunkCount ) * i );
+      const char* nl  = pos < end ? (const char*)std::memchr( pos, '\n', end - pos ) : NULL;
+      bounds[i]       = nl == NULL ? end : nl + 1;
+    }
+    std::vector<Model>          chunks( chunkCount );
+    std::vector<ObjParserState> states( chunkCount );
+#pragma omp parallel for schedule( static, 1 )
+    for ( int i = 0; i < chunkCount; ++i ) { parseObj( bounds[i], bounds[i + 1], chunks[i], states[i] ); }
+
+    // a malformed line at the start of a chunk would have needed the state of the previous
+    // chunk, in this rare case we parse the file sequentially to get the same result.
+    parsed = true;
+    for ( int i = 1; i < chunkCount; ++i ) parsed = parsed && !states[i].carried;
+    if ( parsed ) {
+      // stitch the chunks in file order, indices in OBJ files are global to the file so
+      // they do not need any offset
+      std::vector<size_t> v( chunkCount + 1, output.vertices.size() ), vt( chunkCount + 1, output.uvcoords.size() ),
+          vn( chunkCount + 1, output.normals.size() ), c( chunkCount + 1, output.colors.size() ),
+          f( chunkCount + 1, output.triangles.size() ), fuv( chunkCount + 1, output.trianglesuv.size() );
+      for ( int i = 0; i < chunkCount; ++i ) {
+        v[i + 1]   = v[i] + chunks[i].vertices.size();
+        vt[i + 1]  = vt[i] + chunks[i].uvcoords.size();
+        vn[i + 1]  = vn[i] + chunks[i].normals.size();
+        c[i + 1]   = c[i] + chunks[i].colors.size();
+        f[i + 1]   = f[i] + chunks[i].triangles.size();
+        fuv[i + 1] = fuv[i] + chunks[i].trianglesuv.size();
+        if ( chunks[i].header != "" ) output.header = chunks[i].header;
+      }
+      output.vertices.resize( v[chunkCount] );
+      output.uvcoords.resize( vt[chunkCount] );
+      output.normals.resize( vn[chunkCount] );
+      output.colors.resize( c[chunkCount] );
+      output.triangles.resize( f[chunkCount] );
+      output.trianglesuv.resize( fuv[chunkCount] );
+#pragma omp parallel for schedule( static, 1 )
+      for ( int i = 0; i < chunkCount; ++i ) {
+        copyAt( chunks[i].vertices, output.vertices, v[i] );
+        copyAt( chunks[i].uvcoords, output.uvcoords, vt[i] );
+        copyAt( chunks[i].normals, output.normals, vn[i] );
+        copyAt( chunks[i].colors, output.colors, c[i] );
+        copyAt( chunks[i].triangles, output.triangles, f[i] );
+        copyAt( chunks[i].trianglesuv, output.trianglesuv, fuv[i] );
+        chunks[i] = Model();
+      }
+    }
+  }
+  if ( !parsed ) {
+    ObjParserState state;
+    parseObj( data, end, output, state );
   }
-  fin.close();
-  delete[] buf;
 
   if ( output.normals.size() != 0 && output.normals.size() != output.vertices.size() ) {
-    std::cout << "Warning: obj read, normals with separate index table are not yet supported. Skipping normals."
+    IO::log() << "Warning: obj read, normals with separate index table are not yet supported. Skipping normals."
               << std::endl;
     output.normals.clear();
   }
@@ -435,7 +983,325 @@ void set( std::shared_ptr<tinyply::PlyData> src,
   }
 }
 
+// Native reader for the common ply layouts, decodes the mapped file directly
+// into the model arrays. Supports ascii and binary_little_endian files made of a
+// vertex element with scalar properties and an optional face element with a
+// single vertex_indices list of triangles. Returns false, leaving the model
+// arrays empty, for any other layout so that the caller can fall back to tinyply.
+class PlyNativeReader {
+ public:
+  enum Type { INVALID, INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+  // corrupted is set if the element counts of the header do not fit in the file, such a file
+  // is not handed to another reader that would allocate the arrays before reading them
+  static bool load( const char* data, size_t size, Model& output, bool& corrupted ) {
+    PlyNativeReader reader( data, data + size );
+    const bool      success = reader.readHeader() && reader.readData( output );
+    corrupted               = reader._corrupted;
+    if ( success ) return true;
+    output.vertices.clear();
+    output.normals.clear();
+    output.colors.clear();
+    output.uvcoords.clear();
+    output.triangles.clear();
+    return false;
+  }
+
+ private:
+  struct Property {
+    std::string name;
+    Type        type     = INVALID;
+    Type        listType = INVALID;  // INVALID for scalar properties
+    size_t      offset   = 0;        // offset in the binary element record
+  };
+  struct Element {
+    std::string           name;
+    size_t                count  = 0;
+    size_t                stride = 0;
+    std::vector<Property> properties;
+  };
+
+  const char*          _cur;
+  const char*          _end;
+  bool                 _binary    = false;
+  bool                 _corrupted = false;
+  std::vector<Element> _elements;
+
+  PlyNativeReader( const char* begin, const char* end ) : _cur( begin ), _end( end ) {}
+
+  static Type typeFromString( const std::string& t ) {
+    if ( t == "char" || t == "int8" ) return INT8;
+    if ( t == "uchar" || t == "uint8" ) return UINT8;
+    if ( t == "short" || t == "int16" ) return INT16;
+    if ( t == "ushort" || t == "uint16" ) return UINT16;
+    if ( t == "int" || t == "int32" ) return INT32;
+    if ( t == "uint" || t == "uint32" ) return UINT32;
+    if ( t == "float" || t == "float32" ) return FLOAT32;
+    if ( t == "double" || t == "float64" ) return FLOAT64;
+    return INVALID;
+  }
+  static size_t typeSize( Type t ) {
+    static const size_t sizes[] = { 0, 1, 1, 2, 2, 4, 4, 4, 8 };
+    return sizes[t];
+  }
+
+  template <typename S>
+  static inline S raw( const char* src ) {
+    S v;
+    std::memcpy( &v, src, sizeof( S ) );
+    return v;
+  }
+
+  // reads a little endian binary value of type t and casts it to T
+  template <typename T>
+  static inline T binaryValue( const char* src, Type t ) {
+    switch ( t ) {
+    case FLOAT32: return (T)raw<float>( src );
+    case UINT8: return (T)raw<uint8_t>( src );
+    case INT8: return (T)raw<int8_t>( src );
+    case INT16: return (T)raw<int16_t>( src );
+    case UINT16: return (T)raw<uint16_t>( src );
+    case INT32: return (T)raw<int32_t>( src );
+    case UINT32: return (T)raw<uint32_t>( src );
+    case FLOAT64: return (T)raw<double>( src );
+    default: return T( 0 );
+    }
+  }
+
+  // reads the next ascii value of type t and casts it to T, same conversions as the tinyply streams
+  template <typename T>
+  static inline bool asciiValue( LineReader& in, Type t, T& res ) {
+    if ( t == FLOAT32 ) {
+      float v;
+      if ( !in.number( v ) ) return false;
+      res = (T)v;
+      return true;
+    }
+    const char *begin, *last;
+    if ( !in.token( begin, last ) ) return false;
+    if ( t == FLOAT64 ) {
+      std::string str( begin, last );
+      char*       end = NULL;
+      double      v   = std::strtod( str.c_str(), &end );
+      if ( end != str.c_str() + str.size() ) return false;
+      res = (T)v;
+      return true;
+    }
+    // integers, only plain decimal values
+    bool negative = false;
+    if ( *begin == '-' || *begin == '+' ) negative = *begin++ == '-';
+    if ( begin == last ) return false;
+    int64_t v = 0;
+    for ( ; begin < last; ++begin ) {
+      if ( !LineReader::isDigit( *begin ) ) return false;
+      v = v * 10 + ( *begin - '0' );
+    }
+    if ( negative ) v = -v;
+    switch ( t ) {
+    case INT8: res = (T)(int8_t)v; break;
+    case UINT8: res = (T)(uint8_t)v; break;
+    case INT16: res = (T)(int16_t)v; break;
+    case UINT16: res = (T)(uint16_t)v; break;
+    case INT32: res = (T)(int32_t)v; break;
+    case UINT32: res = (T)(uint32_t)v; break;
+    default: return false;
+    }
+    return true;
+  }
+
+  bool readHeader( void ) {
+    bool magic = false, format = false;
+    while ( _cur < _end ) {
+      const char* next = (const char*)std::memchr( _cur, '\n', _end - _cur );
+      if ( next == NULL ) return false;
+      std::istringstream ls( std::string( _cur, next ) );
+      _cur = next + 1;
+      std::string token;
+      ls >> token;
+      if ( token == "ply" || token == "PLY" ) magic = true;
+      else if ( token == "" || token == "comment" || token == "obj_info" ) continue;
+      else if ( token == "format" ) {
+        std::string fmt;
+        ls >> fmt;
+        if ( fmt == "ascii" ) _binary = false;
+        else if ( fmt == "binary_little_endian" ) _binary = true;
+        else return false;  // big endian left to tinyply
+        format = true;
+      } else if ( token == "element" ) {
+        Element element;
+        ls >> element.name >> element.count;
+        if ( !ls ) return false;
+        _elements.push_back( element );
+      } else if ( token == "property" ) {
+        if ( _elements.empty() ) return false;
+        Property    prop;
+        std::string type;
+        ls >> type;
+        if ( type == "list" ) {
+          std::string countType;
+          ls >> countType >> type;
+          prop.listType = typeFromString( countType );
+          if ( prop.listType == INVALID ) return false;
+        }
+        prop.type = typeFromString( type );
+        ls >> prop.name;
+        if ( prop.type == INVALID || !ls ) return false;
+        Element& element = _elements.back();
+        prop.offset      = element.stride;
+        element.stride += typeSize( prop.type );
+        element.properties.push_back( prop );
+      } else if ( token == "end_header" ) {
+        return magic && format;
+      } else return false;
+    }
+    return false;
+  }
+
+  // checks that the remaining data can hold count records of values values each, before the arrays
+  // are allocated. binary records take stride bytes, ascii values at least a digit and a separator.
+  bool fits( const size_t count, const size_t stride, const size_t values ) {
+    const size_t available = (size_t)( _end - _cur ) + ( _binary ? 0 : 1 );
+    const size_t size      = _binary ? stride : 2 * values;
+    if ( size != 0 && count > available / size ) _corrupted = true;
+    return !_corrupted;
+  }
+
+  static const Property* find( const Element& element, const char* name ) {
+    for ( auto& prop : element.properties )
+      if ( prop.name == name ) return &prop;
+    return NULL;
+  }
+
+  bool readData( Model& output ) {
+    const uint16_t one = 1;
+    if ( _binary && *(const uint8_t*)&one != 1 ) return false;  // big endian host
+    for ( auto& element : _elements ) {
+      if ( element.name == "vertex" ) {
+        if ( !readVertices( element, output ) ) return false;
+      } else if ( element.name == "face" ) {
+        if ( !readFaces( element, output ) ) return false;
+      } else return false;
+    }
+    return true;
+  }
+
+  bool readVertices( const Element& element, Model& output ) {
+    static const char* names[] = { "x", "y", "z", "nx", "ny", "nz", "red", "green", "blue", "texture_u", "texture_v" };
+    const Property*    props[11];
+    for ( size_t i = 0; i < 11; ++i ) props[i] = find( element, names[i] );
+    if ( !props[6] && !props[7] && !props[8] ) {
+      props[6] = find( element, "r" );
+      props[7] = find( element, "g" );
+      props[8] = find( element, "b" );
+    }
+    // only scalar properties, positions are mandatory, no alpha and complete groups
+    for ( auto& prop : element.properties )
+      if ( prop.listType != INVALID ) return false;
+    if ( !props[0] || !props[1] || !props[2] ) return false;
+    if ( find( element, "alpha" ) || find( element, "a" ) ) return false;
+    const bool hasNormals = props[3] && props[4] && props[5];
+    const bool hasColors  = props[6] && props[7] && props[8];
+    const bool hasUvs     = props[9] && props[10];
+    if ( !hasNormals && ( props[3] || props[4] || props[5] ) ) return false;
+    if ( !hasColors && ( props[6] || props[7] || props[8] ) ) return false;
+    if ( !hasUvs && ( props[9] || props[10] ) ) return false;
+
+    const size_t count = element.count;
+    if ( !fits( count, element.stride, element.properties.size() ) ) return false;
+    output.vertices.resize( count * 3 );
+    if ( hasNormals ) output.normals.resize( count * 3 );
+    if ( hasColors ) output.colors.resize( count * 3 );
+    if ( hasUvs ) output.uvcoords.resize( count * 2 );
+
+    if ( _binary ) {
+      const char* src = _cur;
+      for ( size_t i = 0; i < count; ++i, src += element.stride ) {
+        for ( size_t c = 0; c < 3; ++c )
+          output.vertices[i * 3 + c] = binaryValue<float>( src + props[c]->offset, props[c]->type );
+        if ( hasNormals ) {
+          for ( size_t c = 0; c < 3; ++c )
+            output.normals[i * 3 + c] = binaryValue<float>( src + props[3 + c]->offset, props[3 + c]->type );
+        }
+        if ( hasColors ) {
+          for ( size_t c = 0; c < 3; ++c )
+            output.colors[i * 3 + c] = binaryValue<float>( src + props[6 + c]->offset, props[6 + c]->type );
+        }
+        if ( hasUvs ) {
+          for ( size_t c = 0; c < 2; ++c )
+            output.uvcoords[i * 2 + c] = binaryValue<float>( src + props[9 + c]->offset, props[9 + c]->type );
+        }
+      }
+      _cur = src;
+    } else {
+      // destination of each property of the records, -1 if skipped
+      std::vector<int> slots( element.properties.size(), -1 );
+      for ( size_t c = 0; c < 11; ++c )
+        if ( props[c] ) slots[props[c] - element.properties.data()] = (int)c;
+      LineReader in( _cur, _end );
+      for ( size_t i = 0; i < count; ++i ) {
+        for ( size_t j = 0; j < slots.size(); ++j ) {
+          float value;
+          if ( !asciiValue( in, element.properties[j].type, value ) ) return false;
+          const int c = slots[j];
+          if ( c < 0 ) continue;
+          if ( c < 3 ) output.vertices[i * 3 + c] = value;
+          else if ( c < 6 ) output.normals[i * 3 + c - 3] = value;
+          else if ( c < 9 ) output.colors[i * 3 + c - 6] = value;
+          else output.uvcoords[i * 2 + c - 9] = value;
+        }
+      }
+      _cur = in.p;
+    }
+    return true;
+  }
+
+  bool readFaces( const Element& element, Model& output ) {
+    if ( element.properties.size() != 1 || element.properties[0].name != "vertex_indices" ||
+         element.properties[0].listType == INVALID ) {
+      return false;
+    }
+    const Property& prop      = element.properties[0];
+    const size_t    count     = element.count;
+    const size_t    countSize = typeSize( prop.listType );
+    const size_t    indexSize = typeSize( prop.type );
+    const size_t    stride    = countSize + 3 * indexSize;
+    if ( !fits( count, stride, 4 ) ) return false;
+    output.triangles.resize( count * 3 );
+    if ( _binary ) {
+      const char* src = _cur;
+      for ( size_t i = 0; i < count; ++i, src += stride ) {
+        if ( binaryValue<int64_t>( src, prop.listType ) != 3 ) return false;  // not a triangle
+        for ( size_t c = 0; c < 3; ++c )
+          output.triangles[i * 3 + c] = binaryValue<int>( src + countSize + c * indexSize, prop.type );
+      }
+      _cur = src;
+    } else {
+      LineReader in( _cur, _end );
+      for ( size_t i = 0; i < count; ++i ) {
+        int64_t size;
+        if ( !asciiValue( in, prop.listType, size ) || size != 3 ) return false;
+        for ( size_t c = 0; c < 3; ++c )
+          if ( !asciiValue( in, prop.type, output.triangles[i * 3 + c] ) ) return false;
+      }
+      _cur = in.p;
+    }
+    return true;
+  }
+};
+
 bool IO::_loadPly( std::string filename, Model& output ) {
+  // try the native reader first, fall back to tinyply for other layouts
+  {
+    MappedFile mapped;
+    bool       corrupted = false;
+    if ( mapped.open( filename ) && PlyNativeReader::load( mapped.data(), mapped.size(), output, corrupted ) ) {
+      return true;
+    }
+    if ( corrupted ) {
+      IO::errorLog() << "Error: " << filename << " is truncated or its header is corrupted" << std::endl;
+      return false;
+    }
+  }
   std::unique_ptr<std::istream> file_stream;
   file_stream.reset( new std::ifstream( filename.c_str(), std::ios::binary ) );
   tinyply::PlyFile file;
@@ -448,10 +1314,10 @@ bool IO::_loadPly( std::string filename, Model& output ) {
   // like vertex position are hard-coded:
   try {
     _vertices = file.request_properties_from_element( "vertex", { "x", "y", "z" } );
-  } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  } catch ( const std::exception& e ) { IO::errorLog() << "skipping: " << e.what() << std::endl; }
   try {
     _normals = file.request_properties_from_element( "vertex", { "nx", "ny", "nz" } );
-  } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  } catch ( const std::exception& e ) { IO::errorLog() << "skipping: " << e.what() << std::endl; }
 
   try {
     _colors = file.request_properties_from_element( "vertex", { "red", "green", "blue" } );
@@ -475,17 +1341,17 @@ bool IO::_loadPly( std::string filename, Model& output ) {
   // arbitrary ply files, it is best to leave this 0.
   try {
     _faces = file.request_properties_from_element( "face", { "vertex_indices" }, 3 );
-  } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  } catch ( const std::exception& e ) { IO::errorLog() << "skipping: " << e.what() << std::endl; }
 
   try {
     _uvfaces = file.request_properties_from_element( "face", { "texcoord" }, 6 );
-  } catch ( const std::exception& e ) { std::cerr << "skipping: " << e.what() << std::endl; }
+  } catch ( const std::exception& e ) { IO::errorLog() << "skipping: " << e.what() << std::endl; }
 
   // // Tristrips must always be read with a 0 list size hint (unless you know exactly how many elements
   // // are specifically in the file, which is unlikely);
   // try {
   //   _tripstrip = file.request_properties_from_element( "tristrips", {"vertex_indices"}, 0 );
-  // } catch ( const std::exception& e ) { std::cerr << "skipping " << e.what() << std::endl; }
+  // } catch ( const std::exception& e ) { IO::errorLog() << "skipping " << e.what() << std::endl; }
 
   file.read( *file_stream );
 
@@ -505,7 +1371,96 @@ bool IO::_loadPly( std::string filename, Model& output ) {
   return true;
 }
 
-bool IO::_savePly( std::string filename, const Model& input ) {
+// writes the model in a binary_little_endian ply file
+static bool savePlyBinary( std::string filename, const Model& input ) {
+  FILE* file = fopen( filename.c_str(), "wb" );
+  if ( file == NULL ) {
+    std::cerr << "Error: can't open file " << filename << std::endl;
+    return false;
+  }
+  const size_t vertexCount = input.vertices.size() / 3;
+  const size_t faceCount   = input.triangles.size() / 3;
+  const bool   hasNormals  = input.normals.size() == input.vertices.size();
+  const bool   hasColors   = input.colors.size() == input.vertices.size();
+
+  fprintf( file, "ply\nformat binary_little_endian 1.0\n" );
+  fprintf( file, "comment Generated by InterDigital model processor\n" );
+  for ( size_t i = 0; i < input.comments.size(); i++ ) { fprintf( file, "comment %s\n", input.comments[i].c_str() ); }
+  fprintf( file, "element vertex %zu\n", vertexCount );
+  fprintf( file, "property float x\nproperty float y\nproperty float z\n" );
+  if ( hasNormals ) fprintf( file, "property float nx\nproperty float ny\nproperty float nz\n" );
+  if ( hasColors ) fprintf( file, "property uchar red\nproperty uchar green\nproperty uchar blue\n" );
+  if ( faceCount != 0 ) {
+    fprintf( file, "element face %zu\n", faceCount );
+    fprintf( file, "property list uchar int vertex_indices\n" );
+  }
+  fprintf( file, "end_header\n" );
+
+  // byte order of the host, data are swapped if needed
+  const uint16_t one          = 1;
+  const bool     littleEndian = *(const uint8_t*)&one == 1;
+  auto           put          = [&]( uint8_t* dst, const void* src ) {
+    const uint8_t* b = (const uint8_t*)src;
+    if ( littleEndian ) std::memcpy( dst, b, 4 );
+    else {
+      dst[0] = b[3];
+      dst[1] = b[2];
+      dst[2] = b[1];
+      dst[3] = b[0];
+    }
+  };
+
+  bool success = true;
+  if ( !hasNormals && !hasColors && littleEndian ) {
+    // the positions array is the exact binary payload
+    success = fwrite( input.vertices.data(), sizeof( float ), input.vertices.size(), file ) == input.vertices.size();
+  } else {
+    // interleave the attributes by blocks of vertices
+    const size_t         stride = 12 + ( hasNormals ? 12 : 0 ) + ( hasColors ? 3 : 0 );
+    const size_t         block  = 65536;
+    std::vector<uint8_t> buffer( stride * std::min( block, vertexCount ) );
+    for ( size_t start = 0; start < vertexCount && success; start += block ) {
+      const size_t count = std::min( block, vertexCount - start );
+      uint8_t*     dst   = buffer.data();
+      for ( size_t i = start; i < start + count; i++ ) {
+        for ( size_t c = 0; c < 3; c++, dst += 4 ) put( dst, &input.vertices[i * 3 + c] );
+        if ( hasNormals ) {
+          for ( size_t c = 0; c < 3; c++, dst += 4 ) put( dst, &input.normals[i * 3 + c] );
+        }
+        if ( hasColors ) {
+          for ( size_t c = 0; c < 3; c++ ) {
+            *dst++ = (uint8_t)std::min( 255.0f, std::max( 0.0f, std::roundf( input.colors[i * 3 + c] ) ) );
+          }
+        }
+      }
+      success = fwrite( buffer.data(), stride, count, file ) == count;
+    }
+  }
+
+  // topology, one uchar count followed by three int per face
+  if ( success && faceCount != 0 ) {
+    const size_t         stride = 13;
+    const size_t         block  = 65536;
+    std::vector<uint8_t> buffer( stride * std::min( block, faceCount ) );
+    for ( size_t start = 0; start < faceCount && success; start += block ) {
+      const size_t count = std::min( block, faceCount - start );
+      uint8_t*     dst   = buffer.data();
+      for ( size_t i = start; i < start + count; i++ ) {
+        *dst++ = 3;
+        for ( size_t c = 0; c < 3; c++, dst += 4 ) put( dst, &input.triangles[i * 3 + c] );
+      }
+      success = fwrite( buffer.data(), stride, count, file ) == count;
+    }
+  }
+
+  if ( fclose( file ) != 0 ) success = false;
+  if ( !success ) std::cerr << "Error: can't write file " << filename << std::endl;
+  return success;
+}
+
+bool IO::_savePly( std::string filename, const Model& input, bool binary ) {
+  if ( binary ) return savePlyBinary( filename, input );
+
   std::ofstream fout;
   // use a big 4MB buffer to accelerate writes
   char* buf = new char[4 * 1024 * 1024 + 1];
@@ -573,17 +1528,169 @@ bool IO::_savePly( std::string filename, const Model& input ) {
   return true;
 }
 
+// MMB container, all values little endian:
+//   char     magic[4]      "MMB" followed by a null character
+//   uint32_t version       MMB_VERSION of the writer
+//   uint32_t flags         MMB_FLAG_CHECKSUMS if the checksums are set
+//   uint32_t arrayCount    number of arrays in the file
+//   uint32_t loaderVersion IO::LOADER_VERSION of the writer, since version 2
+//   uint32_t reserved      zero, since version 2
+//   { uint64_t byteSize; uint64_t checksum; } for each array
+//   the raw arrays, in order vertices, uvcoords, normals, colors, triangles,
+//   trianglesuv and header, each one starting on a 16 bytes boundary.
+// Readers ignore the arrays they do not know so that new arrays can be appended
+// in later versions without breaking the format.
+static const char     MMB_MAGIC[4]       = { 'M', 'M', 'B', '\0' };
+static const uint32_t MMB_VERSION        = 2;
+static const uint32_t MMB_FLAG_CHECKSUMS = 1;
+static const uint32_t MMB_ARRAY_COUNT    = 7;
+static const size_t   MMB_ALIGNMENT      = 16;
+
+// size of the fixed part of the header of a given version
+static inline size_t mmbHeaderSize( uint32_t version ) { return version >= 2 ? 24 : 16; }
+
+// fast 64 bits hash of a buffer, FNV-1a applied on 64 bits words
+static uint64_t mmbChecksum( const void* data, size_t size ) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  uint64_t       hash  = 0xcbf29ce484222325ull;
+  size_t         i     = 0;
+  for ( ; i + 8 <= size; i += 8 ) {
+    uint64_t word;
+    std::memcpy( &word, bytes + i, 8 );
+    hash = ( hash ^ word ) * 0x100000001b3ull;
+  }
+  for ( ; i < size; ++i ) hash = ( hash ^ bytes[i] ) * 0x100000001b3ull;
+  return hash;
+}
+
+static inline size_t mmbAlign( size_t offset ) { return ( offset + MMB_ALIGNMENT - 1 ) / MMB_ALIGNMENT * MMB_ALIGNMENT; }
+
+template <typename T>
+static inline void mmbRead( std::vector<T>& dst, const char* src, uint64_t size ) {
+  dst.resize( size / sizeof( T ) );
+  if ( size != 0 ) std::memcpy( dst.data(), src, size );
+}
+
+static inline bool isLittleEndianHost( void ) {
+  const uint16_t one = 1;
+  return *(const uint8_t*)&one == 1;
+}
+
+bool IO::_saveMmb( std::string filename, const Model& input ) {
+  if ( !isLittleEndianHost() ) {
+    std::cerr << "Error: mmb files can only be written on little endian systems" << std::endl;
+    return false;
+  }
+  const void* arrays[MMB_ARRAY_COUNT] = { input.vertices.data(),  input.uvcoords.data(),    input.normals.data(),
+                                          input.colors.data(),    input.triangles.data(),   input.trianglesuv.data(),
+                                          input.header.data() };
+  const uint64_t sizes[MMB_ARRAY_COUNT] = { input.vertices.size() * sizeof( float ),
+                                            input.uvcoords.size() * sizeof( float ),
+                                            input.normals.size() * sizeof( float ),
+                                            input.colors.size() * sizeof( float ),
+                                            input.triangles.size() * sizeof( int ),
+                                            input.trianglesuv.size() * sizeof( int ),
+                                            input.header.size() };
+  FILE* file = fopen( filename.c_str(), "wb" );
+  if ( file == NULL ) {
+    std::cerr << "Error: can't open file " << filename << std::endl;
+    return false;
+  }
+  const uint32_t head[5] = { MMB_VERSION, MMB_FLAG_CHECKSUMS, MMB_ARRAY_COUNT, LOADER_VERSION, 0 };
+  bool           success = fwrite( MMB_MAGIC, 1, 4, file ) == 4 && fwrite( head, 4, 5, file ) == 5;
+  for ( size_t i = 0; i < MMB_ARRAY_COUNT && success; ++i ) {
+    const uint64_t entry[2] = { sizes[i], mmbChecksum( arrays[i], sizes[i] ) };
+    success                 = fwrite( entry, 8, 2, file ) == 2;
+  }
+  size_t        offset                 = mmbHeaderSize( MMB_VERSION ) + MMB_ARRAY_COUNT * 16;
+  const uint8_t padding[MMB_ALIGNMENT] = { 0 };
+  for ( size_t i = 0; i < MMB_ARRAY_COUNT && success; ++i ) {
+    const size_t start = mmbAlign( offset );
+    success            = fwrite( padding, 1, start - offset, file ) == start - offset;
+    if ( success && sizes[i] != 0 ) success = fwrite( arrays[i], 1, sizes[i], file ) == sizes[i];
+    offset = start + sizes[i];
+  }
+  if ( fclose( file ) != 0 ) success = false;
+  if ( !success ) std::cerr << "Error: can't write file " << filename << std::endl;
+  return success;
+}
+
+bool IO::_loadMmb( std::string filename, Model& output, uint32_t* loaderVersion ) {
+  if ( !isLittleEndianHost() ) {
+    IO::errorLog() << "Error: mmb files can only be read on little endian systems" << std::endl;
+    return false;
+  }
+  MappedFile file;
+  if ( !file.open( filename ) ) {
+    IO::errorLog() << "Error: can't open file " << filename << std::endl;
+    return false;
+  }
+  const char* data = file.data();
+  uint32_t    head[3];
+  if ( file.size() < 16 || std::memcmp( data, MMB_MAGIC, 4 ) != 0 ) {
+    IO::errorLog() << "Error: " << filename << " is not a mmb file" << std::endl;
+    return false;
+  }
+  std::memcpy( head, data + 4, 12 );
+  const uint32_t version = head[0], flags = head[1], arrayCount = head[2];
+  if ( version > MMB_VERSION ) {
+    IO::errorLog() << "Error: mmb file " << filename << " version " << version << " is not supported (max "
+              << MMB_VERSION << ")" << std::endl;
+    return false;
+  }
+  const size_t headerSize = mmbHeaderSize( version );
+  if ( arrayCount < MMB_ARRAY_COUNT || file.size() < headerSize + (size_t)arrayCount * 16 ) {
+    IO::errorLog() << "Error: mmb file " << filename << " is corrupted" << std::endl;
+    return false;
+  }
+  // version 1 files do not record the loader, 0 is older than any loader version
+  if ( loaderVersion != NULL ) {
+    *loaderVersion = 0;
+    if ( version >= 2 ) std::memcpy( loaderVersion, data + 16, 4 );
+  }
+  // locate and check the arrays
+  const char* arrays[MMB_ARRAY_COUNT];
+  uint64_t    sizes[MMB_ARRAY_COUNT];
+  size_t      offset = headerSize + (size_t)arrayCount * 16;
+  for ( size_t i = 0; i < MMB_ARRAY_COUNT; ++i ) {
+    uint64_t entry[2];
+    std::memcpy( entry, data + headerSize + i * 16, 16 );
+    const size_t start = mmbAlign( offset );
+    if ( start > file.size() || entry[0] > file.size() - start ||
+         ( i < MMB_ARRAY_COUNT - 1 && entry[0] % 4 != 0 ) ) {
+      IO::errorLog() << "Error: mmb file " << filename << " is corrupted" << std::endl;
+      return false;
+    }
+    arrays[i] = data + start;
+    sizes[i]  = entry[0];
+    if ( ( flags & MMB_FLAG_CHECKSUMS ) && mmbChecksum( arrays[i], sizes[i] ) != entry[1] ) {
+      IO::errorLog() << "Error: mmb file " << filename << " checksum mismatch" << std::endl;
+      return false;
+    }
+    offset = start + sizes[i];
+  }
+  // copy to the model, no parsing needed
+  mmbRead( output.vertices, arrays[0], sizes[0] );
+  mmbRead( output.uvcoords, arrays[1], sizes[1] );
+  mmbRead( output.normals, arrays[2], sizes[2] );
+  mmbRead( output.colors, arrays[3], sizes[3] );
+  mmbRead( output.triangles, arrays[4], sizes[4] );
+  mmbRead( output.trianglesuv, arrays[5], sizes[5] );
+  output.header.assign( arrays[6], sizes[6] );
+  return true;
+}
+
 bool IO::_loadImage( std::string filename, Image& output ) {
   // Reading map if needed
   if ( filename != "" ) {
-    std::cout << "Input map: " << filename << std::endl;
+    IO::log() << "Input map: " << filename << std::endl;
     output.data = stbi_load( filename.c_str(), &output.width, &output.height, &output.nbc, 0 );
     if ( output.data == NULL ) {
-      std::cout << "Error: opening file " << filename << std::endl;
+      IO::log() << "Error: opening file " << filename << std::endl;
       return false;
     }
   } else {
-    std::cout << "Error: invalid empty filename" << std::endl;
+    IO::log() << "Error: invalid empty filename" << std::endl;
     return false;
   }
 
@@ -19,12 +19,16 @@
 //
 #include <set>
 #include <map>
-#include <list>
 #include <vector>
+#include <array>
+#include <utility>
 #include <algorithm>
 #include <functional>
 #include <iostream>
 #include <time.h>
+#ifdef OPENMP_FOUND
+#  include <omp.h>
+#endif
 // mathematics
 #include <glm/vec3.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -34,28 +38,162 @@
 
 using namespace mm;
 
-//
-void Model::normalizeNormals( void ) {
-  // normalize vertex normals if any
-  for ( size_t i = 0; i < getNormalCount(); i++ ) {
-    glm::vec3 normal = fetchNormal( i );
-    normal           = glm::normalize( normal );
-    if ( std::isnan( normal[0] ) ) {
-      // use default z normal if invalid face
-      normal = glm::vec3( 0.0F, 0.0F, 1.0F );
+namespace {
+
+// sorts data with comp, chunks of the vector are sorted on several threads
+// and then merged two by two. comp shall be a strict weak ordering.
+template <typename T, typename Compare>
+void parallelSort( std::vector<T>& data, Compare comp ) {
+  size_t chunkCount = 1;
+#ifdef OPENMP_FOUND
+  chunkCount = std::min( (size_t)omp_get_max_threads(), data.size() / 65536 );
+#endif
+  if ( chunkCount <= 1 ) {
+    std::sort( data.begin(), data.end(), comp );
+    return;
+  }
+  std::vector<size_t> bounds( chunkCount + 1 );
+  for ( size_t c = 0; c <= chunkCount; ++c ) bounds[c] = data.size() * c / chunkCount;
+#pragma omp parallel for
+  for ( int64_t c = 0; c < (int64_t)chunkCount; ++c ) {
+    std::sort( data.begin() + bounds[c], data.begin() + bounds[c + 1], comp );
+  }
+  std::vector<T> buffer( data.size() );
+  for ( size_t width = 1; width < chunkCount; width *= 2 ) {
+#pragma omp parallel for
+    for ( int64_t c = 0; c < (int64_t)chunkCount; c += 2 * width ) {
+      const size_t first = bounds[c];
+      const size_t mid   = bounds[std::min( c + width, chunkCount )];
+      const size_t last  = bounds[std::min( c + 2 * width, chunkCount )];
+      std::merge( data.begin() + first,
+                  data.begin() + mid,
+                  data.begin() + mid,
+                  data.begin() + last,
+                  buffer.begin() + first,
+                  comp );
     }
-    for ( glm::vec3::length_type c = 0; c < 3; c++ ) { normals[i * 3 + c] = normal[c]; }
+    data.swap( buffer );
+  }
+}
+
+// orders vertex indices by position as CompareVertex<true, false, false, false> does, then by
+// index so that the order is total. once sorted, the vertices of same position are contiguous.
+struct LessPosition {
+  const float* vertices;
+
+  LessPosition( const std::vector<float>& v ) : vertices( v.data() ) {}
+
+  inline bool operator()( const uint32_t a, const uint32_t b ) const {
+    const float* pa = &vertices[(size_t)a * 3];
+    const float* pb = &vertices[(size_t)b * 3];
+    if ( pa[0] != pb[0] ) return pa[0] < pb[0];
+    if ( pa[1] != pb[1] ) return pa[1] < pb[1];
+    if ( pa[2] != pb[2] ) return pa[2] < pb[2];
+    return a < b;
   }
 
-  // normalze triangle normals if any
-  for ( size_t i = 0; i < getFaceNormalCount(); i++ ) {
-    glm::vec3 normal = fetchFaceNormal( i );
-    normal           = glm::normalize( normal );
-    if ( std::isnan( normal[0] ) ) {
-      // use default z normal if invalid face
-      normal = glm::vec3( 0.0F, 0.0F, 1.0F );
+  inline bool samePosition( const uint32_t a, const uint32_t b ) const {
+    const float* pa = &vertices[(size_t)a * 3];
+    const float* pb = &vertices[(size_t)b * 3];
+    return pa[0] == pb[0] && pa[1] == pb[1] && pa[2] == pb[2];
+  }
+};
+
+// returns the indices of the vertices used by the triangles, sorted by LessPosition
+std::vector<uint32_t> sortUsedVertices( const Model& model ) {
+  std::vector<uint8_t> used( model.getPositionCount(), 0 );
+  for ( const auto index : model.triangles ) used[index] = 1;
+  std::vector<uint32_t> sorted;
+  sorted.reserve( model.getPositionCount() );
+  for ( size_t v = 0; v < model.getPositionCount(); ++v ) {
+    if ( used[v] ) sorted.push_back( (uint32_t)v );
+  }
+  parallelSort( sorted, LessPosition( model.vertices ) );
+  return sorted;
+}
+
+// lists the triangles of each vertex by counting sort, once per corner and in triangle order
+Adjacency listVertexTriangles( const Model& model ) {
+  const size_t vertCount = model.getPositionCount();
+  Adjacency    output;
+  output.offsets.assign( vertCount + 1, 0 );
+  for ( const auto index : model.triangles ) output.offsets[index + 1]++;
+  for ( size_t v = 0; v < vertCount; ++v ) output.offsets[v + 1] += output.offsets[v];
+  output.items.resize( model.triangles.size() );
+  std::vector<size_t> cursor( output.offsets.begin(), output.offsets.end() - 1 );
+  for ( size_t i = 0; i < model.triangles.size(); ++i ) {
+    output.items[cursor[model.triangles[i]]++] = (uint32_t)( i / 3 );
+  }
+  return output;
+}
+
+// builds an adjacency of keyCount keys on several threads, items( key, list ) shall
+// append to list the sorted unique items of key. keys are processed by blocks whose
+// results are concatenated in key order.
+template <typename Items>
+void buildAdjacency( const size_t keyCount, Adjacency& output, Items items ) {
+  const size_t           blockSize  = 4096;
+  const size_t           blockCount = ( keyCount + blockSize - 1 ) / blockSize;
+  std::vector<Adjacency> blocks( blockCount );
+#pragma omp parallel for schedule( dynamic )
+  for ( int64_t block = 0; block < (int64_t)blockCount; ++block ) {
+    std::vector<uint32_t> list;
+    const size_t          last = std::min( keyCount, ( block + 1 ) * blockSize );
+    for ( size_t key = block * blockSize; key < last; ++key ) {
+      list.clear();
+      items( key, list );
+      blocks[block].push_back( list.begin(), list.end() );
+    }
+  }
+  std::vector<size_t> starts( blockCount + 1, 0 );
+  for ( size_t b = 0; b < blockCount; ++b ) starts[b + 1] = starts[b] + blocks[b].items.size();
+  output.offsets.resize( keyCount + 1 );
+  output.offsets[0] = 0;
+  output.items.resize( starts[blockCount] );
+#pragma omp parallel for
+  for ( int64_t b = 0; b < (int64_t)blockCount; ++b ) {
+    for ( size_t k = 1; k < blocks[b].offsets.size(); ++k ) {
+      output.offsets[b * blockSize + k] = starts[b] + blocks[b].offsets[k];
+    }
+    std::copy( blocks[b].items.begin(), blocks[b].items.end(), output.items.begin() + starts[b] );
+    blocks[b] = Adjacency();
+  }
+}
+
+}  // namespace
+
+// vectorized by compiler
+void Vec3Soa::fromAos( const std::vector<float>& aos ) {
+  resize( aos.size() / 3 );
+  for ( size_t i = 0; i < size(); ++i ) {
+    x[i] = aos[i * 3 + 0];
+    y[i] = aos[i * 3 + 1];
+    z[i] = aos[i * 3 + 2];
+  }
+}
+
+// vectorized by compiler
+void Vec3Soa::toAos( std::vector<float>& aos ) const {
+  aos.resize( size() * 3 );
+  for ( size_t i = 0; i < size(); ++i ) {
+    aos[i * 3 + 0] = x[i];
+    aos[i * 3 + 1] = y[i];
+    aos[i * 3 + 2] = z[i];
+  }
+}
+
+//
+void Model::normalizeNormals( void ) {
+  // normalize vertex normals if any, then triangle normals if any, by blocks on several threads
+  const size_t blockSize = 4096;
+  for ( auto* array : { &normals, &faceNormals } ) {
+    const size_t  count      = array->size() / 3;
+    const int64_t blockCount = ( count + blockSize - 1 ) / blockSize;
+#pragma omp parallel for
+    for ( int64_t block = 0; block < blockCount; ++block ) {
+      const size_t first = block * blockSize;
+      Geometry::normalizeBatch( std::min( blockSize, count - first ), &( *array )[first * 3] );
     }
-    for ( glm::vec3::length_type c = 0; c < 3; c++ ) { faceNormals[i * 3 + c] = normal[c]; }
   }
 }
 
@@ -63,19 +201,16 @@ void Model::normalizeNormals( void ) {
 void Model::computeFaceNormals( bool normalize ) {
   // allocate output
   faceNormals.resize( getTriangleCount() * 3 );
-  //
-  for ( size_t t = 0; t < getTriangleCount(); t++ ) {
-    //
-    const glm::vec3 v1 = fetchPosition( t, 0 );
-    const glm::vec3 v2 = fetchPosition( t, 1 );
-    const glm::vec3 v3 = fetchPosition( t, 2 );
-    // computes face normal
-    glm::vec3       faceNormal;
-    const glm::vec3 v12 = v2 - v1;
-    const glm::vec3 v13 = v3 - v1;
-    faceNormal          = glm::cross( v12, v13 );
-    // write the result
-    for ( glm::vec3::length_type c = 0; c < 3; c++ ) { faceNormals[t * 3 + c] = faceNormal[c]; }
+  // computes the face normals by blocks on several threads
+  const size_t  blockSize  = 4096;
+  const int64_t blockCount = ( getTriangleCount() + blockSize - 1 ) / blockSize;
+#pragma omp parallel for
+  for ( int64_t block = 0; block < blockCount; ++block ) {
+    const size_t first = block * blockSize;
+    Geometry::computeFaceNormalsBatch( std::min( blockSize, getTriangleCount() - first ),
+                                       vertices.data(),
+                                       &triangles[first * 3],
+                                       &faceNormals[first * 3] );
   }
   // normalize if requested
   if ( normalize ) { normalizeNormals(); }
@@ -87,63 +222,46 @@ void Model::computeVertexNormals( bool normalize, bool noSeams ) {
   if ( !hasTriangleNormals() ) { computeFaceNormals( false ); }
   //
   normals.resize( vertices.size(), 0.0F );
-  // map ( position -> map ( vertexIndex, faceNormal ))
-  // used in no seams mode
-  auto cmp = []( const glm::vec3& a, const glm::vec3& b ) {
-    if ( a.x != b.x ) return a.x < b.x;
-    if ( a.y != b.y ) return a.y < b.y;
-    return a.z < b.z;
-  };
-
-  typedef std::map<int, glm::vec3>                                                                       TmpVertNormals;
-  typedef std::map<glm::vec3, TmpVertNormals, std::function<bool( const glm::vec3&, const glm::vec3& )>> TmpPosNormals;
 
-  TmpPosNormals tmpNormals( cmp );
-
-  //
-  for ( size_t t = 0; t < getTriangleCount(); t++ ) {
-    int idx[3];
-    fetchTriangleIndices( t, idx[0], idx[1], idx[2] );
-    const glm::vec3 normal = fetchFaceNormal( t );
-
-    if ( noSeams ) {
-      glm::vec3 pos[3];
-      fetchTriangleVertices( t, pos[0], pos[1], pos[2] );
-      for ( size_t i = 0; i < 3; i++ ) {
-        // p1
-        auto posIter = tmpNormals.find( pos[i] );
-        bool found   = false;
-        if ( posIter != tmpNormals.end() ) {
-          auto vertIter = posIter->second.find( idx[i] );
-          if ( vertIter != posIter->second.end() ) {
-            vertIter->second = vertIter->second + normal;
-            found            = true;
-          }
-        }
-        if ( !found ) tmpNormals[pos[i]][idx[i]] = normal;
-      }
-    } else {
-      for ( size_t i = 0; i < 3; i++ ) {
-        for ( glm::vec3::length_type c = 0; c < 3; c++ ) { normals[idx[i] * 3 + c] += normal[c]; }
-      }
+  // triangles of each vertex, once per corner and in triangle order, so that each vertex sums the
+  // face normals in the same order as a sequential accumulation and without concurrent writes
+  const Adjacency vertexTriangles = listVertexTriangles( *this );
+
+  if ( noSeams ) {
+    // welds the positions, the vertices of same position are contiguous and in index order
+    const std::vector<uint32_t> sorted = sortUsedVertices( *this );
+    const LessPosition          lessPos( vertices );
+    std::vector<size_t>         runs;
+    for ( size_t k = 0; k < sorted.size(); ++k ) {
+      if ( k == 0 || !lessPos.samePosition( sorted[k - 1], sorted[k] ) ) runs.push_back( k );
     }
-  }
+    runs.push_back( sorted.size() );
 
-  if ( noSeams ) {  // second pass in noseams mode
-    TmpPosNormals::const_iterator  posIter;
-    TmpVertNormals::const_iterator vertIter;
-    // iteratr the positions
-    for ( posIter = tmpNormals.begin(); posIter != tmpNormals.end(); posIter++ ) {
-      // iterates the vertices that share the same position and cumulate normals
+    // the normal of a position is the sum, in index order, of the per vertex sums of face normals
+    // in triangle order, it is assigned to all the vertices of the position
+#pragma omp parallel for schedule( dynamic, 1024 )
+    for ( int64_t r = 0; r < (int64_t)runs.size() - 1; ++r ) {
       glm::vec3 normal( 0.0F, 0.0F, 0.0F );
-      for ( vertIter = posIter->second.begin(); vertIter != posIter->second.end(); vertIter++ ) {
-        normal += vertIter->second;
+      for ( size_t k = runs[r]; k < runs[r + 1]; ++k ) {
+        const auto vertTriangles = vertexTriangles[sorted[k]];
+        glm::vec3  sum           = fetchFaceNormal( vertTriangles[0] );
+        for ( size_t c = 1; c < vertTriangles.size(); ++c ) sum = sum + fetchFaceNormal( vertTriangles[c] );
+        normal += sum;
       }
-      // assign normal sum to all the indices of this position
-      for ( vertIter = posIter->second.begin(); vertIter != posIter->second.end(); vertIter++ ) {
-        for ( glm::vec3::length_type c = 0; c < 3; c++ ) { normals[vertIter->first * 3 + c] = normal[c]; }
+      for ( size_t k = runs[r]; k < runs[r + 1]; ++k ) {
+        for ( glm::vec3::length_type c = 0; c < 3; c++ ) { normals[sorted[k] * 3 + c] = normal[c]; }
       }
     }
+  } else {
+    // each vertex adds the normals of its triangles to its current normal
+#pragma omp parallel for
+    for ( int64_t v = 0; v < (int64_t)getPositionCount(); ++v ) {
+      const auto vertTriangles = vertexTriangles[v];
+      if ( vertTriangles.empty() ) continue;
+      glm::vec3 normal = fetchNormal( v );
+      for ( const auto t : vertTriangles ) normal += fetchFaceNormal( t );
+      for ( glm::vec3::length_type c = 0; c < 3; c++ ) { normals[v * 3 + c] = normal[c]; }
+    }
   }
 
   if ( normalize ) { normalizeNormals(); }
@@ -156,270 +274,215 @@ void Model::computeNeighborTriangles( bool useIndices, bool skipNonManifold ) {
 
   clock_t t1 = clock();
 
-  // clear map information on neigborhood
+  // clear information on neigborhood
   perVertexTriangles.clear();
   perTriangleNeighborTriangles.clear();
   perTriangleEdgeNeighborTriangles.clear();
   nonManifoldTriangles.clear();
   nonManifoldVertices.clear();
 
-  // build the map with list of triangle index for all vertex
+  const size_t triCount  = getTriangleCount();
+  const size_t vertCount = getPositionCount();
+
+  // class of each vertex: its index if useIndices is set, otherwise the vertices of same
+  // position are in the same class, found by sorting the vertices used by the triangles.
+  const uint32_t        noClass = UINT32_MAX;
+  std::vector<uint32_t> vertClass( vertCount, noClass );
+  size_t                classCount = 0;
   if ( useIndices ) {
-    for ( size_t triIndex = 0; triIndex < getTriangleCount(); ++triIndex ) {
-      int i[3];
-      fetchTriangleIndices( triIndex, i[0], i[1], i[2] );
-      for ( size_t vertIdx = 0; vertIdx < 3; ++vertIdx ) { perVertexTriangles[i[vertIdx]].insert( triIndex ); }
-    }
+    classCount = vertCount;
+    for ( size_t v = 0; v < vertCount; ++v ) vertClass[v] = (uint32_t)v;
   } else {
-    std::map<Vertex, std::set<size_t>, CompareVertex<true, false, false, false>> perPositionVertexIndex;
-    for ( size_t triIndex = 0; triIndex < getTriangleCount(); ++triIndex ) {
-      Vertex v[3];
-      fetchTriangleVertices( triIndex, v[0].pos, v[1].pos, v[2].pos );
-      int i[3];
-      fetchTriangleIndices( triIndex, i[0], i[1], i[2] );
-      for ( size_t vertIdx = 0; vertIdx < 3; ++vertIdx ) { perPositionVertexIndex[v[vertIdx]].insert( i[vertIdx] ); }
-    }
-    for ( size_t triIndex = 0; triIndex < getTriangleCount(); ++triIndex ) {
-      Vertex v[3];
-      fetchTriangleVertices( triIndex, v[0].pos, v[1].pos, v[2].pos );
-
-      for ( size_t vertIdx = 0; vertIdx < 3; ++vertIdx ) {
-        auto& vertIndices = perPositionVertexIndex[v[vertIdx]];
-        // iterates over all the indices having same position
-        for ( auto iter = vertIndices.begin(); iter != vertIndices.end(); ++iter ) {
-          perVertexTriangles[*iter].insert( triIndex );
-        }
-      }
+    const std::vector<uint32_t> sorted = sortUsedVertices( *this );
+    const LessPosition          lessPos( vertices );
+    for ( size_t k = 0; k < sorted.size(); ++k ) {
+      if ( k != 0 && !lessPos.samePosition( sorted[k - 1], sorted[k] ) ) classCount++;
+      vertClass[sorted[k]] = (uint32_t)classCount;
     }
+    if ( !sorted.empty() ) classCount++;
   }
 
-  // build the map with list of neighbor triangle index with same vertex
-  for ( size_t triIndex = 0; triIndex < getTriangleCount(); ++triIndex ) {
-    int i[3];
-    fetchTriangleIndices( triIndex, i[0], i[1], i[2] );
-    for ( size_t vertIdx = 0; vertIdx < 3; ++vertIdx ) {
-      auto iter = perVertexTriangles.find( i[vertIdx] );
-      perTriangleNeighborTriangles[triIndex].insert( iter->second.begin(), iter->second.end() );
+  // fetch the classes of the three vertices of a triangle
+  auto fetchClasses = [&]( const size_t triIndex, uint32_t c[3] ) {
+    for ( size_t vertIdx = 0; vertIdx < 3; ++vertIdx ) c[vertIdx] = vertClass[triangles[triIndex * 3 + vertIdx]];
+  };
+
+  // build the list of triangle indices of each class by counting sort, each list is
+  // sorted since the triangles are visited in order, a triangle is listed once per class
+  // even if degenerate.
+  Adjacency classTriangles;
+  {
+    auto& offsets = classTriangles.offsets;
+    offsets.assign( classCount + 1, 0 );
+    for ( size_t triIndex = 0; triIndex < triCount; ++triIndex ) {
+      uint32_t c[3];
+      fetchClasses( triIndex, c );
+      offsets[c[0] + 1]++;
+      if ( c[1] != c[0] ) offsets[c[1] + 1]++;
+      if ( c[2] != c[0] && c[2] != c[1] ) offsets[c[2] + 1]++;
     }
+    for ( size_t c = 0; c < classCount; ++c ) offsets[c + 1] += offsets[c];
+    classTriangles.items.resize( offsets[classCount] );
+    std::vector<size_t> cursor( offsets.begin(), offsets.end() - 1 );
+    for ( size_t triIndex = 0; triIndex < triCount; ++triIndex ) {
+      uint32_t c[3];
+      fetchClasses( triIndex, c );
+      classTriangles.items[cursor[c[0]]++] = (uint32_t)triIndex;
+      if ( c[1] != c[0] ) classTriangles.items[cursor[c[1]]++] = (uint32_t)triIndex;
+      if ( c[2] != c[0] && c[2] != c[1] ) classTriangles.items[cursor[c[2]]++] = (uint32_t)triIndex;
+    }
+  }
 
-    // remove self
-    perTriangleNeighborTriangles[triIndex].erase( triIndex );
+  // each vertex gets the triangles of its class, vertices not used by any triangle get none,
+  // with indices the classes are the vertices and the lists are moved once done
+  if ( !useIndices ) {
+    auto& offsets = perVertexTriangles.offsets;
+    offsets.assign( vertCount + 1, 0 );
+    for ( size_t v = 0; v < vertCount; ++v ) {
+      offsets[v + 1] = offsets[v] + ( vertClass[v] == noClass ? 0 : classTriangles[vertClass[v]].size() );
+    }
+    perVertexTriangles.items.resize( offsets[vertCount] );
+#pragma omp parallel for
+    for ( int64_t v = 0; v < (int64_t)vertCount; ++v ) {
+      if ( vertClass[v] == noClass ) continue;
+      const auto range = classTriangles[vertClass[v]];
+      std::copy( range.begin(), range.end(), perVertexTriangles.items.begin() + offsets[v] );
+    }
   }
 
-  // compute non-manifold vertices
-  if ( useIndices ) {
-    // TODO
-  } else {
-    // std::cout << "generate clusters" << std::endl;
-    // vertex id -> list < vertex id >
-    std::map<size_t, std::list<std::set<size_t>>> allVertexClusters;
-    // First create a set of clusters
-    // elem->first is vertex index
-    // elem->second is list of triangles
-    for ( auto elem : perVertexTriangles ) {
-      const auto vertIndex = elem.first;
-      for ( auto triIdx : elem.second ) {
-        std::set<size_t> cluster;
-        int              tri[3];
-        fetchTriangleIndices( triIdx, tri[0], tri[1], tri[2] );
-        // create a new entry in the clusters
+  // build the list of neighbor triangle index with same vertex,
+  // merge of the sorted lists of the three classes without self
+  buildAdjacency( triCount, perTriangleNeighborTriangles, [&]( const size_t triIndex, std::vector<uint32_t>& list ) {
+    uint32_t c[3];
+    fetchClasses( triIndex, c );
+    for ( size_t vertIdx = 0; vertIdx < 3; ++vertIdx ) {
+      const auto range = classTriangles[c[vertIdx]];
+      list.insert( list.end(), range.begin(), range.end() );
+    }
+    std::sort( list.begin(), list.end() );
+    list.erase( std::unique( list.begin(), list.end() ), list.end() );
+    // remove self
+    list.erase( std::remove( list.begin(), list.end(), (uint32_t)triIndex ), list.end() );
+  } );
+
+  // compute non-manifold vertices. the triangles of a class are grouped in fans, two triangles
+  // are in the same fan if they share an edge of the class, i.e. another class. The vertices of
+  // the class are non-manifold if more than one fan is found. union find per class, linear
+  // in the number of triangles per class but for the sort of their few other classes.
+  std::vector<uint8_t> classNonManifold( classCount, 0 );
+#pragma omp parallel
+  {
+    std::vector<std::pair<uint32_t, uint32_t>> others;  // other class, triangle rank in the class
+    std::vector<uint32_t>                      parent;  // union find of the triangle ranks
+    auto                                       find = [&]( uint32_t i ) {
+      while ( parent[i] != i ) i = parent[i] = parent[parent[i]];
+      return i;
+    };
+#pragma omp for schedule( dynamic, 1024 )
+    for ( int64_t cls = 0; cls < (int64_t)classCount; ++cls ) {
+      const auto clsTriangles = classTriangles[cls];
+      if ( clsTriangles.size() < 2 ) continue;
+      others.clear();
+      parent.resize( clsTriangles.size() );
+      size_t fanCount = 0;
+      for ( uint32_t rank = 0; rank < clsTriangles.size(); ++rank ) {
+        parent[rank] = rank;
+        uint32_t c[3];
+        fetchClasses( clsTriangles[rank], c );
+        const size_t size = others.size();
         for ( size_t i = 0; i < 3; ++i ) {
-          if ( tri[i] != vertIndex ) cluster.insert( tri[i] );
+          if ( c[i] != cls ) others.push_back( std::make_pair( c[i], rank ) );
         }
-        //
-        allVertexClusters[elem.first].push_back( cluster );
+        // triangles collapsed on the class do not belong to any fan
+        if ( others.size() != size ) fanCount++;
       }
-    }
-
-    // DEBUG
-    /*
-    for (auto perVertexCluster : allVertexClusters) {
-            std::cout << "vertexIndex = " << perVertexCluster.first << std::endl;
-            for (auto cluster : perVertexCluster.second) {
-                    std::cout << "(";
-                    for (auto vertex : cluster) {
-                            std::cout << " " << vertex << " ";
-                    }
-                    std::cout << ")";
-            }
-            std::cout << std::endl;
-    }*/
-
-    // std::cout << "Fusion the clusters two by two" << std::endl;
-    for ( auto& vertexClusters : allVertexClusters ) {
-      // std::cout << "Treating vertex " << vertexClusters.first << " size = " << vertexClusters.second.size() <<
-      // std::endl; from first cluster to end
-      auto& clusters         = vertexClusters.second;
-      auto  firstClusterIter = clusters.begin();
-      while ( firstClusterIter != clusters.end() ) {
-        bool found = false;
-        do {
-          found = false;
-          // from firstClusterIter + 1 to end
-          auto scndClusterIter = firstClusterIter;
-          scndClusterIter++;
-          while ( scndClusterIter != clusters.end() ) {
-            std::set<size_t> intersection;
-            auto&            firstCluster = *firstClusterIter;
-            auto&            scndCluster  = *scndClusterIter;
-            std::set_intersection( firstCluster.begin(),
-                                   firstCluster.end(),
-                                   scndCluster.begin(),
-                                   scndCluster.end(),
-                                   std::inserter( intersection, intersection.begin() ) );
-
-            if ( intersection.size() != 0 ) {
-              found = true;
-              // std::cout << "Merging clusters" << std::endl;
-              firstCluster.insert( scndCluster.begin(), scndCluster.end() );
-              scndClusterIter = vertexClusters.second.erase( scndClusterIter );
-              /*
-              // DEBUG
-              for (auto cluster : vertexClusters.second) {
-                      std::cout << "(";
-                      for (auto vertex : cluster) {
-                              std::cout << " " << vertex << " ";
-                      }
-                      std::cout << ")";
-              }
-              std::cout << std::endl;
-              */
-            } else {
-              scndClusterIter++;
-            }
-          }
-        } while ( found );
-        firstClusterIter++;
-      }
-      if ( vertexClusters.second.size() > 1 ) {
-        nonManifoldVertices.insert( vertexClusters.first );
-        // DEBUG
-        /*
-        std::cout << "Error: vertex " << vertexClusters.first << " is non-manifold: " << vertexClusters.second.size() <<
-        std::endl; for (auto cluster : vertexClusters.second) { std::cout << "("; for (auto vertex : cluster) {
-                        std::cout << " " << vertex << " ";
-                }
-                std::cout << ")";
+      std::sort( others.begin(), others.end() );
+      for ( size_t k = 1; k < others.size(); ++k ) {
+        if ( others[k].first != others[k - 1].first ) continue;
+        const uint32_t a = find( others[k - 1].second );
+        const uint32_t b = find( others[k].second );
+        if ( a != b ) {
+          parent[std::max( a, b )] = std::min( a, b );
+          fanCount--;
         }
-        std::cout << std::endl;
-        */
       }
+      classNonManifold[cls] = fanCount > 1;
     }
-
-    // DEBUG
-    /*
-    for (auto perVertexCluster : allVertexClusters) {
-            std::cout << "vertexIndex = " << perVertexCluster.first << std::endl;
-            for (auto cluster : perVertexCluster.second) {
-                    std::cout << "(";
-                    for (auto vertex : cluster) {
-                            std::cout << " " << vertex << " ";
-                    }
-                    std::cout << ")";
-            }
-            std::cout << std::endl;
-    }*/
+  }
+  for ( size_t v = 0; v < vertCount; ++v ) {
+    if ( vertClass[v] != noClass && classNonManifold[vertClass[v]] )
+      nonManifoldVertices.insert( nonManifoldVertices.end(), v );
   }
   // if (nonManifoldVertices.size() != 0)
   //	std::cout << "Error: found " << nonManifoldVertices.size() << " non manifold vertices" << std::endl;
 
-  // compute per edge triangle neighbors and detects non-manifold edges
-  if ( useIndices ) {
-    // TODO
-  } else {
-    for ( size_t triIndex = 0; triIndex < getTriangleCount(); ++triIndex ) {
-      int i[3];
-      fetchTriangleIndices( triIndex, i[0], i[1], i[2] );
-
-      auto& s0 = perVertexTriangles[i[0]];
-      auto& s1 = perVertexTriangles[i[1]];
-      auto& s2 = perVertexTriangles[i[2]];
-
-      std::set<size_t> intersect1;
-      std::set_intersection(
-        s0.begin(), s0.end(), s1.begin(), s1.end(), std::inserter( intersect1, intersect1.begin() ) );
-      intersect1.erase( triIndex );  // remove self
-      if ( intersect1.size() > 1 ) {
-        if ( skipNonManifold ) {
-          /*
-          std::cout << "Error: mesh is non-manifold " << intersect1.size() << std::endl;
-          std::cout << "Triangle " << triIndex << " edge s0-s1 ( " << intersect1.size() << " ) --> ";
-          for (auto elem : intersect1) std::cout << elem << " ";
-          std::cout << std::endl;
-          */
-        } else {
-          perTriangleEdgeNeighborTriangles[triIndex].insert( intersect1.begin(), intersect1.end() );
-        }
-        nonManifoldTriangles.insert( triIndex );
-      } else if ( intersect1.size() == 1 ) {
-        perTriangleEdgeNeighborTriangles[triIndex].insert( *intersect1.begin() );
-      } else {
-        // no neighbor by this edge
+  // sort the edge keys: each edge between two distinct classes a < b is bucketed
+  // by a and stored as b << 32 | half edge index, then each bucket is sorted.
+  // the triangles sharing an edge are then contiguous and in order.
+  std::vector<size_t>   edgeOffsets( classCount + 1, 0 );
+  std::vector<uint64_t> edges;
+  for ( size_t triIndex = 0; triIndex < triCount; ++triIndex ) {
+    uint32_t c[3];
+    fetchClasses( triIndex, c );
+    for ( size_t e = 0; e < 3; ++e ) {
+      if ( c[e] != c[( e + 1 ) % 3] ) edgeOffsets[std::min( c[e], c[( e + 1 ) % 3] ) + 1]++;
+    }
+  }
+  for ( size_t c = 0; c < classCount; ++c ) edgeOffsets[c + 1] += edgeOffsets[c];
+  edges.resize( edgeOffsets[classCount] );
+  {
+    std::vector<size_t> cursor( edgeOffsets.begin(), edgeOffsets.end() - 1 );
+    for ( size_t triIndex = 0; triIndex < triCount; ++triIndex ) {
+      uint32_t c[3];
+      fetchClasses( triIndex, c );
+      for ( size_t e = 0; e < 3; ++e ) {
+        const uint32_t a = std::min( c[e], c[( e + 1 ) % 3] );
+        const uint32_t b = std::max( c[e], c[( e + 1 ) % 3] );
+        if ( a != b ) edges[cursor[a]++] = (uint64_t)b << 32 | ( triIndex * 3 + e );
       }
+    }
+  }
+#pragma omp parallel for schedule( dynamic, 1024 )
+  for ( int64_t cls = 0; cls < (int64_t)classCount; ++cls ) {
+    std::sort( edges.begin() + edgeOffsets[cls], edges.begin() + edgeOffsets[cls + 1] );
+  }
 
-      std::set<size_t> intersect2;
-      std::set_intersection(
-        s1.begin(), s1.end(), s2.begin(), s2.end(), std::inserter( intersect2, intersect2.begin() ) );
-      intersect2.erase( triIndex );  // remove self
-      if ( intersect2.size() > 1 ) {
-        if ( skipNonManifold ) {
-          /*
-          std::cout << "Error: mesh is non-manifold " << intersect2.size() << std::endl;
-          std::cout << "Triangle " << triIndex << " edge s1-s2 ( " << intersect2.size() << " ) --> ";
-          for (auto elem : intersect2) std::cout << elem << " ";
-          std::cout << std::endl;
-          */
+  // compute per edge triangle neighbors and detects non-manifold edges
+  std::vector<uint8_t> triNonManifold( triCount, 0 );
+  buildAdjacency(
+    triCount, perTriangleEdgeNeighborTriangles, [&]( const size_t triIndex, std::vector<uint32_t>& list ) {
+      uint32_t c[3];
+      fetchClasses( triIndex, c );
+      for ( size_t e = 0; e < 3; ++e ) {
+        const uint32_t a = std::min( c[e], c[( e + 1 ) % 3] );
+        const uint32_t b = std::max( c[e], c[( e + 1 ) % 3] );
+        // appends the other triangles of the edge, they come in order so duplicates are adjacent
+        const size_t first = list.size();
+        auto         add   = [&]( const uint32_t tri ) {
+          if ( tri != triIndex && ( list.size() == first || list.back() != tri ) ) list.push_back( tri );
+        };
+        if ( a == b ) {
+          // degenerate edge, shared by all the triangles of the class
+          for ( const auto tri : classTriangles[a] ) add( tri );
         } else {
-          perTriangleEdgeNeighborTriangles[triIndex].insert( intersect2.begin(), intersect2.end() );
+          const auto end  = edges.begin() + edgeOffsets[a + 1];
+          auto       iter = std::lower_bound( edges.begin() + edgeOffsets[a], end, (uint64_t)b << 32 );
+          for ( ; iter != end && ( *iter >> 32 ) == b; ++iter ) add( (uint32_t)( ( *iter & 0xFFFFFFFF ) / 3 ) );
         }
-        nonManifoldTriangles.insert( triIndex );
-      } else if ( intersect2.size() == 1 ) {
-        perTriangleEdgeNeighborTriangles[triIndex].insert( *intersect2.begin() );
-      } else {
-        // no neighbor by this edge
-      }
-
-      std::set<size_t> intersect3;
-      std::set_intersection(
-        s2.begin(), s2.end(), s0.begin(), s0.end(), std::inserter( intersect3, intersect3.begin() ) );
-      intersect3.erase( triIndex );  // remove self
-      if ( intersect3.size() > 1 ) {
-        if ( skipNonManifold ) {
-          /*
-          std::cout << "Error: mesh is non-manifold " << intersect3.size() << std::endl;
-          std::cout << "Triangle " << triIndex << " edge s2-s0 ( " << intersect3.size() << " ) --> ";
-          for (auto elem : intersect3) std::cout << elem << " ";
-          std::cout << std::endl;
-          */
-        } else {
-          perTriangleEdgeNeighborTriangles[triIndex].insert( intersect3.begin(), intersect3.end() );
+        if ( list.size() - first > 1 ) {
+          // more than two triangles share the edge, mesh is non-manifold
+          if ( skipNonManifold ) list.resize( first );
+          triNonManifold[triIndex] = 1;
         }
-        nonManifoldTriangles.insert( triIndex );
-      } else if ( intersect3.size() == 1 ) {
-        perTriangleEdgeNeighborTriangles[triIndex].insert( *intersect3.begin() );
-      } else {
-        // no neighbor by this edge
       }
-    }
-  }
-
-  // debug only
-  /*
-  for (auto triIter = perTriangleNeighborTriangles.begin(); triIter != perTriangleNeighborTriangles.end(); ++triIter) {
-          std::cout << triIter->first << ": ";
-          for (auto setIter = triIter->second.begin(); setIter != triIter->second.end(); ++setIter) {
-                  std::cout << " " << *setIter << std::endl;
-          }
-          std::cout << std::endl;
+      std::sort( list.begin(), list.end() );
+      list.erase( std::unique( list.begin(), list.end() ), list.end() );
+    } );
+  for ( size_t triIndex = 0; triIndex < triCount; ++triIndex ) {
+    if ( triNonManifold[triIndex] ) nonManifoldTriangles.insert( nonManifoldTriangles.end(), triIndex );
   }
 
-  for (auto triIter = perTriangleEdgeNeighborTriangles.begin(); triIter != perTriangleEdgeNeighborTriangles.end();
-  ++triIter) { std::cout << triIter->first << ": "; for (auto setIter = triIter->second.begin(); setIter !=
-  triIter->second.end(); ++setIter) { std::cout << " " << *setIter << std::endl;
-          }
-          std::cout << std::endl;
-  }
-          */
+  if ( useIndices ) perVertexTriangles = std::move( classTriangles );
 
   clock_t t2 = clock();
   std::cout << "<- Model::computeNeighborTriangles, time=" << ( (float)( t2 - t1 ) ) / CLOCKS_PER_SEC << " sec."
@@ -437,4 +500,130 @@ Model& Model::operator+=( const Model& other ) {
     builder.pushTriangle( v1, v2, v3, true );
   }
   return *this;
-}
\ No newline at end of file
+}
+
+// the duplicates across blocks are found by shards of the hash space, concurrently.
+// each shard visits its vertices in block order so the first occurrence of a vertex
+// is the one kept, as with a sequential ModelBuilder.
+void ParallelModelBuilder::findUnique( std::vector<size_t>& offsets, std::vector<uint8_t>& unique ) {
+  const size_t blockCount = _blocks.size();
+  offsets.assign( blockCount + 1, 0 );
+  foundCount = 0;
+  for ( size_t b = 0; b < blockCount; ++b ) {
+    offsets[b + 1] = offsets[b] + _blocks[b].vertices.size();
+    foundCount += _blocks[b].foundCount;
+  }
+  const size_t count = offsets[blockCount];
+
+  // each block is already free of duplicates
+  unique.assign( count, 1 );
+  if ( blockCount > 1 ) {
+    size_t shardCount = 1;
+#ifdef OPENMP_FOUND
+    shardCount = (size_t)omp_get_max_threads();
+#endif
+    // high bits select the shard, low bits are used by the tables
+    auto shardOf = [&]( uint64_t hash ) { return (size_t)( hash >> 40 ) % shardCount; };
+
+    // stable bucketing of the vertices by shard, in block order
+    std::vector<size_t> starts( blockCount * shardCount, 0 );
+#pragma omp parallel for
+    for ( int64_t b = 0; b < (int64_t)blockCount; ++b ) {
+      for ( const uint64_t hash : _blocks[b].hashes ) starts[b * shardCount + shardOf( hash )]++;
+    }
+    std::vector<size_t> shardStarts( shardCount + 1, 0 );
+    size_t              pos = 0;
+    for ( size_t s = 0; s < shardCount; ++s ) {
+      shardStarts[s] = pos;
+      for ( size_t b = 0; b < blockCount; ++b ) {
+        pos += std::exchange( starts[b * shardCount + s], pos );
+      }
+    }
+    shardStarts[shardCount] = pos;
+    std::vector<std::pair<uint32_t, uint32_t>> order( count );  // block, index in block
+#pragma omp parallel for
+    for ( int64_t b = 0; b < (int64_t)blockCount; ++b ) {
+      size_t* cursors = &starts[b * shardCount];
+      for ( size_t i = 0; i < _blocks[b].hashes.size(); ++i ) {
+        order[cursors[shardOf( _blocks[b].hashes[i] )]++] = std::make_pair( (uint32_t)b, (uint32_t)i );
+      }
+    }
+
+    // keep the first occurrence within each shard
+#pragma omp parallel for schedule( dynamic )
+    for ( int64_t s = 0; s < (int64_t)shardCount; ++s ) {
+      // items are the positions in order relative to the shard start
+      const std::pair<uint32_t, uint32_t>* items = &order[shardStarts[s]];
+      auto hashOf  = [&]( uint32_t k ) { return _blocks[items[k].first].hashes[items[k].second]; };
+      auto equalOf = [&]( uint32_t k, uint32_t l ) {
+        return equal( _blocks[items[k].first].vertices[items[k].second],
+                      _blocks[items[l].first].vertices[items[l].second] );
+      };
+      VertexIndexTable table;
+      for ( size_t k = 0; k < shardStarts[s + 1] - shardStarts[s]; ++k ) {
+        if ( table.insert( (uint32_t)k, hashOf, equalOf ) ) unique[offsets[items[k].first] + items[k].second] = 0;
+      }
+    }
+  }
+}
+
+void ParallelModelBuilder::merge( Model& output ) {
+  const size_t         blockCount = _blocks.size();
+  std::vector<size_t>  offsets;
+  std::vector<uint8_t> unique;
+  findUnique( offsets, unique );
+  const size_t count = offsets[blockCount];
+
+  // number of unique vertices of each block having each attribute (pos, nrm, uv, col),
+  // the prefix sums give the range of each block in the output arrays
+  std::vector<std::array<size_t, 4>> starts( blockCount + 1, { 0, 0, 0, 0 } );
+#pragma omp parallel for
+  for ( int64_t b = 0; b < (int64_t)blockCount; ++b ) {
+    std::array<size_t, 4>& counts = starts[b + 1];
+    for ( size_t i = 0; i < _blocks[b].vertices.size(); ++i ) {
+      if ( !unique[offsets[b] + i] ) continue;
+      const Vertex& v = _blocks[b].vertices[i];
+      counts[0]++;
+      counts[1] += v.hasNormal;
+      counts[2] += v.hasUVCoord;
+      counts[3] += v.hasColor;
+    }
+  }
+  starts[0][0] = output.vertices.size() / 3;
+  starts[0][1] = output.normals.size() / 3;
+  starts[0][2] = output.uvcoords.size() / 2;
+  starts[0][3] = output.colors.size() / 3;
+  for ( size_t b = 0; b < blockCount; ++b ) {
+    for ( size_t a = 0; a < 4; ++a ) starts[b + 1][a] += starts[b][a];
+  }
+  foundCount += count - ( starts[blockCount][0] - starts[0][0] );
+  output.vertices.resize( starts[blockCount][0] * 3 );
+  output.normals.resize( starts[blockCount][1] * 3 );
+  output.uvcoords.resize( starts[blockCount][2] * 2 );
+  output.colors.resize( starts[blockCount][3] * 3 );
+
+  // copy the unique vertices in block order
+#pragma omp parallel for
+  for ( int64_t b = 0; b < (int64_t)blockCount; ++b ) {
+    std::array<size_t, 4> cursors = starts[b];
+    for ( size_t i = 0; i < _blocks[b].vertices.size(); ++i ) {
+      if ( !unique[offsets[b] + i] ) continue;
+      const Vertex& v = _blocks[b].vertices[i];
+      std::copy( &v.pos[0], &v.pos[0] + 3, &output.vertices[cursors[0]++ * 3] );
+      if ( v.hasNormal ) std::copy( &v.nrm[0], &v.nrm[0] + 3, &output.normals[cursors[1]++ * 3] );
+      if ( v.hasUVCoord ) std::copy( &v.uv[0], &v.uv[0] + 2, &output.uvcoords[cursors[2]++ * 2] );
+      if ( v.hasColor ) std::copy( &v.col[0], &v.col[0] + 3, &output.colors[cursors[3]++ * 3] );
+    }
+    _blocks[b] = Block();
+  }
+}
+
+size_t ParallelModelBuilder::count() {
+  std::vector<size_t>  offsets;
+  std::vector<uint8_t> unique;
+  findUnique( offsets, unique );
+  const size_t count = std::count( unique.begin(), unique.end(), 1 );
+  foundCount += unique.size() - count;
+  for ( auto& block : _blocks ) block = Block();
+  return count;
+}
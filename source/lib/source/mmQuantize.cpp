@@ -64,6 +64,43 @@ void Quantize::quantize( const Model&       input,
   // copy the input
   output = input;
 
+  quantize( output,
+            qp,
+            qt,
+            qn,
+            qc,
+            outputVarFilename,
+            useFixedPoint,
+            colorSpaceConversion,
+            minPos,
+            maxPos,
+            minUv,
+            maxUv,
+            minNrm,
+            maxNrm,
+            minCol,
+            maxCol,
+            verbose );
+}
+
+// each attribute is read once and overwritten in place by its quantized value
+void Quantize::quantize( Model&             model,
+                         const uint32_t     qp,
+                         const uint32_t     qt,
+                         const uint32_t     qn,
+                         const uint32_t     qc,
+                         const std::string& outputVarFilename,
+                         const bool         useFixedPoint,
+                         const bool         colorSpaceConversion,
+                         glm::vec3&         minPos,
+                         glm::vec3&         maxPos,
+                         glm::vec2&         minUv,
+                         glm::vec2&         maxUv,
+                         glm::vec3&         minNrm,
+                         glm::vec3&         maxNrm,
+                         glm::vec3&         minCol,
+                         glm::vec3&         maxCol,
+                         const bool         verbose ) {
   // prepare logging and output var
   std::vector<std::ostream*> out;
   if ( verbose ) out.push_back( &std::cout );
@@ -82,10 +119,13 @@ void Quantize::quantize( const Model&       input,
   }
 
   // quantize position
-  if ( !input.vertices.empty() && qp >= 7 ) {
+  if ( !model.vertices.empty() && qp >= 7 ) {
+    // one array per component for the packets of the batch functions
+    Vec3Soa positions( model.vertices );
     if ( minPos == maxPos ) {
       if ( verbose ) std::cout << "Computing positions range" << std::endl;
-      Geometry::computeBBox( input.vertices, minPos, maxPos );
+      Geometry::computeBBox(
+        positions.size(), positions.x.data(), positions.y.data(), positions.z.data(), minPos, maxPos );
     } else {
       if ( verbose ) std::cout << "Using parameter positions range" << std::endl;
     }
@@ -114,20 +154,17 @@ void Quantize::quantize( const Model&       input,
       *out[i] << "  scale=" << scale << std::endl;
     }
 
-    for ( size_t i = 0; i < input.vertices.size() / 3; i++ ) {
-      for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
-        uint32_t pos =
-          static_cast<uint32_t>( std::floor( ( ( double( input.vertices[i * 3 + c] - minPos[c] ) ) / scale ) + 0.5f ) );
-        output.vertices[i * 3 + c] = static_cast<float>( pos );
-      }
+    for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
+      Geometry::quantizeBatch( positions.size(), positions[c].data(), minPos[c], scale );
     }
+    positions.toAos( model.vertices );
   }
 
   // quantize UV coordinates
-  if ( !input.uvcoords.empty() && qt >= 7 ) {
+  if ( !model.uvcoords.empty() && qt >= 7 ) {
     if ( minUv == maxUv ) {
       if ( verbose ) std::cout << "Computing uv coordinates range" << std::endl;
-      Geometry::computeBBox( input.uvcoords, minUv, maxUv );
+      Geometry::computeBBox( model.uvcoords, minUv, maxUv );
     } else {
       if ( verbose ) std::cout << "Using parameter uv coordinates range" << std::endl;
     }
@@ -141,20 +178,21 @@ void Quantize::quantize( const Model&       input,
       *out[i] << "  rangeUv=" << range << std::endl;
     }
 
-    for ( size_t i = 0; i < input.uvcoords.size() / 2; i++ ) {
+    for ( size_t i = 0; i < model.uvcoords.size() / 2; i++ ) {
       for ( glm::vec2::length_type c = 0; c < 2; ++c ) {
         uint32_t uv = static_cast<uint32_t>(
-          std::floor( ( ( input.uvcoords[i * 2 + c] - minUv[c] ) / range ) * maxUVcordQuantizedValue + 0.5f ) );
-        output.uvcoords[i * 2 + c] = static_cast<float>( uv );
+          std::floor( ( ( model.uvcoords[i * 2 + c] - minUv[c] ) / range ) * maxUVcordQuantizedValue + 0.5f ) );
+        model.uvcoords[i * 2 + c] = static_cast<float>( uv );
       }
     }
   }
 
   // quantize normals
-  if ( !input.normals.empty() && qn >= 7 ) {
+  if ( !model.normals.empty() && qn >= 7 ) {
+    Vec3Soa normals( model.normals );
     if ( minNrm == maxNrm ) {
       if ( verbose ) std::cout << "Computing normals range" << std::endl;
-      Geometry::computeBBox( input.normals, minNrm, maxNrm );
+      Geometry::computeBBox( normals.size(), normals.x.data(), normals.y.data(), normals.z.data(), minNrm, maxNrm );
     } else {
       if ( verbose ) std::cout << "Using parameter normals range" << std::endl;
     }
@@ -168,20 +206,19 @@ void Quantize::quantize( const Model&       input,
       *out[i] << "  rangeNrm=" << range << std::endl;
     }
 
-    for ( size_t i = 0; i < input.normals.size() / 3; i++ ) {
-      for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
-        uint32_t nrm = static_cast<uint32_t>(
-          std::floor( ( ( input.normals[i * 3 + c] - minNrm[c] ) / range ) * maxNormalQuantizedValue + 0.5f ) );
-        output.normals[i * 3 + c] = static_cast<float>( nrm );
-      }
+    for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
+      Geometry::quantizeBatch(
+        normals.size(), normals[c].data(), minNrm[c], range, static_cast<float>( maxNormalQuantizedValue ) );
     }
+    normals.toAos( model.normals );
   }
 
   // quantize colors
-  if ( !input.colors.empty() && ( ( qc >= 7 ) || ( colorSpaceConversion ) ) ) {
+  if ( !model.colors.empty() && ( ( qc >= 7 ) || ( colorSpaceConversion ) ) ) {
+    Vec3Soa colors( model.colors );
     if ( minCol == maxCol ) {
       if ( verbose ) std::cout << "Computing colors range" << std::endl;
-      Geometry::computeBBox( input.colors, minCol, maxCol );
+      Geometry::computeBBox( colors.size(), colors.x.data(), colors.y.data(), colors.z.data(), minCol, maxCol );
     } else {
       if ( verbose ) std::cout << "Using parameter colors range" << std::endl;
     }
@@ -195,23 +232,25 @@ void Quantize::quantize( const Model&       input,
       *out[i] << "  rangeCol=" << range << std::endl;
     }
 
-    for ( size_t i = 0; i < input.colors.size() / 3; i++ ) {
-      if ( colorSpaceConversion ) {
+    if ( colorSpaceConversion ) {
+      // vectorized by compiler
+      for ( size_t i = 0; i < colors.size(); i++ ) {
         glm::vec3 inYUV_256, inYUV;
-        rgbToYuvBt709_256( glm::vec3( input.colors[i * 3], input.colors[i * 3 + 1], input.colors[i * 3 + 2] ),
-                           inYUV_256 );
+        rgbToYuvBt709_256( colors.fetch( i ), inYUV_256 );
         color256ToUnit( inYUV_256, inYUV );
-        for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
-          uint32_t col             = static_cast<uint32_t>( std::floor( inYUV[c] * maxColorQuantizedValue + 0.5f ) );
-          output.colors[i * 3 + c] = static_cast<float>( col );
-        }
-      } else {
-        for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
-          uint32_t col = static_cast<uint32_t>(
-            std::floor( ( ( input.colors[i * 3 + c] - minCol[c] ) / range ) * maxColorQuantizedValue + 0.5f ) );
-          output.colors[i * 3 + c] = static_cast<float>( col );
-        }
+        colors.store( i, inYUV );
+      }
+      // yuv components are in [0,1], ( value - 0 ) / 1 leaves them unchanged
+      for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
+        Geometry::quantizeBatch(
+          colors.size(), colors[c].data(), 0.0F, 1.0F, static_cast<float>( maxColorQuantizedValue ) );
+      }
+    } else {
+      for ( glm::vec3::length_type c = 0; c < 3; ++c ) {
+        Geometry::quantizeBatch(
+          colors.size(), colors[c].data(), minCol[c], range, static_cast<float>( maxColorQuantizedValue ) );
       }
     }
+    colors.toAos( model.colors );
   }
 }
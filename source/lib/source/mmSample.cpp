@@ -19,7 +19,9 @@
 
 #include <iostream>
 #include <fstream>
+#include <limits>
 #include <set>
+#include <unordered_map>
 #include <time.h>
 #include <math.h>
 // mathematics
@@ -38,14 +40,214 @@
 
 using namespace mm;
 
+namespace {
+
+// closed form estimates of the number of points sampled on a triangle, used to pre-allocate the outputs.
+// the estimates count the points shared with the neighbour triangles.
+
+// sum of the estimates of the triangles [begin,end), estimate( v1, v2, v3 ) giving the one of a triangle
+template <typename Estimate>
+size_t estimatePointCount( const Model& input, size_t begin, size_t end, Estimate estimate ) {
+  size_t count = 0;
+  for ( size_t triIdx = begin; triIdx < end; ++triIdx ) {
+    Vertex v1, v2, v3;
+    fetchTriangle( input, triIdx, input.uvcoords.size() != 0, false, false, v1, v2, v3 );
+    count += estimate( v1, v2, v3 );
+  }
+  return count;
+}
+
+// number of points of a triangle with edges split in n segments
+inline size_t splitPointCount( const size_t n ) { return ( n + 1 ) * ( n + 2 ) / 2; }
+
+// grid, the cells of each plane covered by the projection of the triangle, plus half of its outline.
+// only the plane the most orthogonal to the normal is counted if useNormal is set.
+size_t estimateGridCount( const Vertex& v1, const Vertex& v2, const Vertex& v3, float step, bool useNormal ) {
+  if ( step <= 0.0F ) return 3;
+  // the components are the areas of the projections on the planes orthogonal to the axes
+  const glm::vec3 area = glm::abs( glm::cross( v2.pos - v1.pos, v3.pos - v1.pos ) ) * 0.5F;
+  glm::vec3       triMinBox, triMaxBox;
+  Geometry::triangleBBox( v1.pos, v2.pos, v3.pos, triMinBox, triMaxBox );
+  const glm::vec3 cells = ( triMaxBox - triMinBox ) / step;
+  double          count = 0;
+  for ( glm::vec3::length_type axis = 0; axis < 3; ++axis ) {
+    const double axisCount = area[axis] / ( step * step ) + 0.5 * ( cells[( axis + 1 ) % 3] + cells[( axis + 2 ) % 3] );
+    if ( useNormal ) count = std::max( count, axisCount );
+    else count += axisCount;
+  }
+  return (size_t)count;
+}
+
+// sdiv, the triangle is split in four until the area threshold is reached,
+// and until the texels of the vertices are adjacent if mapThreshold is set
+size_t estimateDivCount(
+  const Vertex& v1, const Vertex& v2, const Vertex& v3, float areaThreshold, const Image* tex_map ) {
+  size_t depth = 0;
+  for ( double area = Geometry::triangleArea( v1.pos, v2.pos, v3.pos ); area >= areaThreshold && depth < 12;
+        area *= 0.25 )
+    ++depth;
+  if ( tex_map != NULL && tex_map->data != NULL ) {
+    const glm::vec2 mapSize( tex_map->width, tex_map->height );
+    const float     texels = std::max( std::max( glm::length( ( v2.uv - v1.uv ) * mapSize ),
+                                                 glm::length( ( v3.uv - v2.uv ) * mapSize ) ),
+                                   glm::length( ( v1.uv - v3.uv ) * mapSize ) );
+    size_t          mapDepth = 0;
+    for ( float length = texels; length > 1.0F && mapDepth < 12; length *= 0.5F ) ++mapDepth;
+    depth = std::max( depth, mapDepth );
+  }
+  return splitPointCount( (size_t)1 << depth );
+}
+
+// ediv, each edge is split in two until half of its length is below the threshold.
+// the interior is bounded by the area, final triangles having edges of about the threshold
+size_t estimateDivEdgeCount( const Vertex& v1, const Vertex& v2, const Vertex& v3, float lengthThreshold ) {
+  if ( lengthThreshold <= 0.0F ) return 3;
+  auto segments = [&]( float length ) {
+    size_t n = 1;
+    for ( ; length * 0.5F >= lengthThreshold && n < 4096; length *= 0.5F ) n *= 2;
+    return n;
+  };
+  const size_t n1 = segments( glm::length( v2.pos - v1.pos ) );
+  const size_t n2 = segments( glm::length( v3.pos - v2.pos ) );
+  const size_t n3 = segments( glm::length( v1.pos - v3.pos ) );
+  const double interior =
+    Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) / ( (double)lengthThreshold * lengthThreshold );
+  return std::min( splitPointCount( std::max( std::max( n1, n2 ), n3 ) ), n1 + n2 + n3 + (size_t)interior );
+}
+
+// face, rows of points along the first edge, each row having a number of points proportional to its
+// position along the second edge, on each layer of the thickness
+size_t estimateFaceCount( const Vertex& v1, const Vertex& v2, const Vertex& v3, float step, float thickness ) {
+  if ( step <= 0.0F ) return 3;
+  const double rows   = std::floor( glm::length( v2.pos - v1.pos ) / step ) + 1.0;
+  const double length = glm::length( v3.pos - v2.pos ) / step;
+  const double layers = 2.0 * std::floor( thickness / step ) + 1.0;
+  return (size_t)( ( rows + 0.5 * length * ( rows - 1.0 ) ) * layers );
+}
+
+// sum of the estimates of all the triangles of the model, blocks of triangles are estimated concurrently
+template <typename Estimate>
+size_t estimateModelPointCount( const Model& input, Estimate estimate ) {
+  const size_t  triangleCount = input.triangles.size() / 3;
+  const size_t  blockSize     = 4096;
+  const int64_t blockCount    = ( triangleCount + blockSize - 1 ) / blockSize;
+  size_t        count         = 0;
+#pragma omp parallel for reduction( + : count )
+  for ( int64_t block = 0; block < blockCount; ++block )
+    count += estimatePointCount(
+      input, block * blockSize, std::min( triangleCount, ( block + 1 ) * blockSize ), estimate );
+  return count;
+}
+
+// search of a sampling density giving between nbSamplesMin and nbSamplesMax points, the point count growing
+// with the density. estimate( density ) is the closed form point count of the model, count( density ) runs
+// the sampler without output and returns its point count. densities are rounded to integers not below
+// minDensity if integral is set, as for resolutions. until the range is bracketed, the estimate is scaled by
+// the ratio of the last count to its estimate, and the density predicted for the middle of the range is
+// searched on the scaled estimate only. once bracketed, the density is interpolated between the bounds in
+// logarithmic scale. the densities already counted bound the prediction, so that the search converges at
+// least as a bisection.
+// returns the density giving a count in the range, or the closest one if none is found, at most
+// maxIterations counts are performed after the initial one.
+template <typename Estimate, typename Counter>
+double searchDensity( double   density,
+                      double   minDensity,
+                      bool     integral,
+                      size_t   nbSamplesMin,
+                      size_t   nbSamplesMax,
+                      size_t   maxIterations,
+                      Estimate estimate,
+                      Counter  count,
+                      size_t&  iterations ) {
+  double lowerBound = 0.0;                                       // largest density giving too few points
+  double upperBound = std::numeric_limits<double>::infinity();  // smallest density giving too many points
+  size_t lowerCount = 0, upperCount = 0;                         // point counts of the bounds
+  size_t pointCount = count( density );
+  iterations        = 0;
+  // the last count becomes a bound
+  auto bound = [&]() {
+    if ( pointCount < nbSamplesMin ) {
+      lowerBound = density;
+      lowerCount = pointCount;
+    } else {
+      upperBound = density;
+      upperCount = pointCount;
+    }
+  };
+  while ( ( pointCount < nbSamplesMin || pointCount > nbSamplesMax ) && iterations < maxIterations ) {
+    iterations++;
+    bound();
+    std::cout << "  posCount=" << pointCount << std::endl;
+    const double target = 0.5 * ( (double)nbSamplesMin + (double)nbSamplesMax );
+    double       next   = 0.0;
+    if ( lowerCount != 0 && upperCount != 0 ) {
+      // the count grows as a power of the density between the bounds
+      const double t = std::log( target / lowerCount ) / std::log( (double)upperCount / lowerCount );
+      next           = lowerBound * std::pow( upperBound / lowerBound, t );
+    } else {
+      // the estimate is calibrated on the last count
+      const double ratio    = (double)pointCount / (double)std::max( estimate( density ), (size_t)1 );
+      const double expected = target / ratio;
+      // brackets the target, then bisects the estimate in logarithmic scale
+      double low = density, high = density;
+      if ( pointCount < nbSamplesMin ) {
+        for ( size_t i = 0; i < 32 && (double)estimate( high ) < expected; ++i ) high *= 2.0;
+      } else {
+        for ( size_t i = 0; i < 32 && (double)estimate( low ) > expected; ++i ) low *= 0.5;
+      }
+      for ( size_t i = 0; i < 24; ++i ) {
+        const double middle = std::sqrt( low * high );
+        if ( (double)estimate( middle ) < expected ) low = middle;
+        else high = middle;
+      }
+      next = std::sqrt( low * high );
+      std::cout << "  ratio=" << ratio << std::endl;
+    }
+    // the prediction is replaced by the middle of the bounds if it falls outside
+    if ( !( next > lowerBound && next < upperBound ) )
+      next = lowerBound == 0.0            ? 0.5 * upperBound
+             : std::isinf( upperBound ) ? 2.0 * lowerBound
+                                        : std::sqrt( lowerBound * upperBound );
+    if ( integral ) {
+      // nearest integer strictly between the bounds
+      next = std::max( minDensity, std::round( next ) );
+      if ( next >= upperBound ) next = upperBound - 1.0;
+      if ( next <= lowerBound ) next = lowerBound + 1.0;
+    }
+    if ( next == density || next <= lowerBound || next >= upperBound || next < minDensity ) break;  // no density left
+    density    = next;
+    pointCount = count( density );
+  }
+  if ( pointCount >= nbSamplesMin && pointCount <= nbSamplesMax ) return density;
+  // keeps the bound closest to the range
+  bound();
+  const bool lower = std::isinf( upperBound ) ||
+                     ( lowerBound != 0.0 && nbSamplesMin - lowerCount <= upperCount - nbSamplesMax );
+  std::cout << "Warning: no density found giving between " << nbSamplesMin << " and " << nbSamplesMax
+            << " points, the closest gives " << ( lower ? lowerCount : upperCount ) << " points" << std::endl;
+  return lower ? lowerBound : upperBound;
+}
+
+// face normals of the triangles first to last - 1 of input, same as Geometry::triangleNormal
+// for the triangles that are not degenerate, computed with the batch functions of Geometry
+void computeBlockNormals( const Model& input, const size_t first, const size_t last, std::vector<glm::vec3>& normals ) {
+  normals.resize( last - first );
+  if ( normals.empty() ) return;
+  Geometry::computeFaceNormalsBatch( last - first, input.vertices.data(), &input.triangles[first * 3], &normals[0].x );
+  Geometry::normalizeBatch( last - first, &normals[0].x );
+}
+
+}  // namespace
+
 // this algorithm was originally developped by Owlii
-void Sample::meshToPcFace( const Model& input,
-                           Model&       output,
-                           const Image& tex_map,
-                           size_t       resolution,
-                           float        thickness,
-                           bool         bilinear,
-                           bool         logProgress ) {
+size_t Sample::meshToPcFace( const Model& input,
+                             Model&       output,
+                             const Image& tex_map,
+                             size_t       resolution,
+                             float        thickness,
+                             bool         bilinear,
+                             bool         logProgress,
+                             bool         countOnly ) {
   // computes the bounding box of the vertices
   glm::vec3 minPos, maxPos;
   Geometry::computeBBox( input.vertices, minPos, maxPos );
@@ -58,80 +260,104 @@ void Sample::meshToPcFace( const Model& input,
   float     step       = boxMaxSize / resolution;
   std::cout << "step = " << step << std::endl;
 
-  // to prevent storing duplicate points, we use a ModelBuilder
-  ModelBuilder builder( output );
+  // to prevent storing duplicate points, we use a ModelBuilder per block of triangles.
+  // blocks are sampled concurrently and merged in triangle order.
+  const size_t         triangleCount = input.triangles.size() / 3;
+  const size_t         blockSize     = 256;
+  const int64_t        blockCount    = ( triangleCount + blockSize - 1 ) / blockSize;
+  // counts compare the colors of the texture map through the uv of the points
+  const bool           textured      = input.uvcoords.size() != 0 && tex_map.data != NULL;
+  ParallelModelBuilder builder( blockCount, countOnly && textured ? &tex_map : NULL, bilinear );
 
   size_t skipped = 0;  // number of degenerate triangles
 
-  for ( size_t t = 0; t < input.triangles.size() / 3; t++ ) {
-    if ( logProgress ) std::cout << '\r' << t << "/" << input.triangles.size() / 3 << std::flush;
+#pragma omp parallel for reduction( + : skipped ) schedule( dynamic )
+  for ( int64_t block = 0; block < blockCount; ++block ) {
+    std::vector<glm::vec3> normals;
+    computeBlockNormals( input, block * blockSize, std::min( triangleCount, ( block + 1 ) * blockSize ), normals );
+    for ( size_t t = block * blockSize; t < std::min( triangleCount, ( block + 1 ) * blockSize ); t++ ) {
+      if ( logProgress ) {
+#pragma omp critical
+        std::cout << '\r' << t << "/" << triangleCount << std::flush;
+      }
 
-    Vertex v1, v2, v3;
+      Vertex v1, v2, v3;
 
-    fetchTriangle(
-      input, t, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
+      fetchTriangle(
+        input, t, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
 
-    // check if triangle is not degenerate
-    if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
-      ++skipped;
-      continue;
-    }
+      // check if triangle is not degenerate
+      if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
+        ++skipped;
+        continue;
+      }
 
-    // compute face normal
-    glm::vec3 normal;
-    Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
+      // face normal
+      const glm::vec3& normal = normals[t - block * blockSize];
 
-    // computes face dimensions for sampling
-    glm::vec3 v12_norm = v2.pos - v1.pos;
-    glm::vec3 v23_norm = v3.pos - v2.pos;
-    float     l12      = glm::length( v12_norm );
-    float     l23      = glm::length( v23_norm );
-    for ( int i = 0; i < 3; i++ ) {
-      v12_norm[i] = v12_norm[i] / l12;
-      v23_norm[i] = v23_norm[i] / l23;
-    }
+      // computes face dimensions for sampling
+      glm::vec3 v12_norm = v2.pos - v1.pos;
+      glm::vec3 v23_norm = v3.pos - v2.pos;
+      float     l12      = glm::length( v12_norm );
+      float     l23      = glm::length( v23_norm );
+      for ( int i = 0; i < 3; i++ ) {
+        v12_norm[i] = v12_norm[i] / l12;
+        v23_norm[i] = v23_norm[i] / l23;
+      }
 
-    // do the sampling
-    for ( float step12 = 0.f; step12 <= l12; step12 += step ) {
-      for ( float step23 = 0.f; step23 <= step12 / l12 * l23; step23 += step ) {
-        float step_normal_bdry = 0.f;
-        while ( step_normal_bdry <= thickness ) { step_normal_bdry += step; }
-        step_normal_bdry -= step;
-
-        for ( float step_normal = -step_normal_bdry; step_normal <= step_normal_bdry; step_normal += step ) {
-          Vertex v;
-          v.pos       = v1.pos + step12 * v12_norm + step23 * v23_norm + step_normal * normal;
-          v.nrm       = normal;
-          v.hasNormal = true;
-
-          // compute the color if any
-          if ( input.uvcoords.size() != 0 && tex_map.data != NULL ) {  // use the texture map
-            // compute UV
-            const glm::vec2 uv{
-              ( v1.uv[0] + step12 / l12 * ( v2.uv[0] - v1.uv[0] ) + step23 / l23 * ( v3.uv[0] - v2.uv[0] ) ),
-              ( v1.uv[1] + step12 / l12 * ( v2.uv[1] - v1.uv[1] ) + step23 / l23 * ( v3.uv[1] - v2.uv[1] ) ) };
-
-            // fetch the color from the map
-            if ( bilinear ) texture2D_bilinear( tex_map, uv, v.col );
-            else texture2D( tex_map, uv, v.col );
-            v.hasColor = true;
-          } else if ( input.colors.size() != 0 ) {  // use color per vertex
-            v.col[0] = v1.col[0] + step12 / l12 * ( v2.col[0] - v1.col[0] ) + step23 / l23 * ( v3.col[0] - v2.col[0] );
-            v.col[1] = v1.col[1] + step12 / l12 * ( v2.col[1] - v1.col[1] ) + step23 / l23 * ( v3.col[1] - v2.col[1] );
-            v.col[2] = v1.col[2] + step12 / l12 * ( v2.col[2] - v1.col[2] ) + step23 / l23 * ( v3.col[2] - v2.col[2] );
-            v.hasColor = true;
-          }
+      // do the sampling
+      for ( float step12 = 0.f; step12 <= l12; step12 += step ) {
+        for ( float step23 = 0.f; step23 <= step12 / l12 * l23; step23 += step ) {
+          float step_normal_bdry = 0.f;
+          while ( step_normal_bdry <= thickness ) { step_normal_bdry += step; }
+          step_normal_bdry -= step;
 
-          // add the vertex
-          builder.pushVertex( v );
+          for ( float step_normal = -step_normal_bdry; step_normal <= step_normal_bdry; step_normal += step ) {
+            Vertex v;
+            v.pos       = v1.pos + step12 * v12_norm + step23 * v23_norm + step_normal * normal;
+            v.nrm       = normal;
+            v.hasNormal = true;
+
+            // compute the color if any
+            if ( input.uvcoords.size() != 0 && tex_map.data != NULL ) {  // use the texture map
+              // compute UV
+              const glm::vec2 uv{
+                ( v1.uv[0] + step12 / l12 * ( v2.uv[0] - v1.uv[0] ) + step23 / l23 * ( v3.uv[0] - v2.uv[0] ) ),
+                ( v1.uv[1] + step12 / l12 * ( v2.uv[1] - v1.uv[1] ) + step23 / l23 * ( v3.uv[1] - v2.uv[1] ) ) };
+
+              // fetch the color from the map, a count keeps the uv for the builder to fetch the colors it compares
+              if ( countOnly ) v.uv = uv;
+              else if ( bilinear ) texture2D_bilinear( tex_map, uv, v.col );
+              else texture2D( tex_map, uv, v.col );
+              v.hasColor = true;
+            } else if ( input.colors.size() != 0 ) {  // use color per vertex
+              v.col[0] =
+                v1.col[0] + step12 / l12 * ( v2.col[0] - v1.col[0] ) + step23 / l23 * ( v3.col[0] - v2.col[0] );
+              v.col[1] =
+                v1.col[1] + step12 / l12 * ( v2.col[1] - v1.col[1] ) + step23 / l23 * ( v3.col[1] - v2.col[1] );
+              v.col[2] =
+                v1.col[2] + step12 / l12 * ( v2.col[2] - v1.col[2] ) + step23 / l23 * ( v3.col[2] - v2.col[2] );
+              v.hasColor = true;
+            }
+
+            // add the vertex
+            builder.pushVertex( block, v );
+          }
         }
       }
     }
   }
+  size_t count = 0;
+  if ( countOnly ) count = builder.count();
+  else {
+    builder.merge( output );
+    count = output.vertices.size() / 3;
+  }
   if ( logProgress ) std::cout << std::endl;
   if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
   if ( builder.foundCount != 0 ) std::cout << "Skipped " << builder.foundCount << " duplicate vertices" << std::endl;
-  std::cout << "Generated " << output.vertices.size() / 3 << " points" << std::endl;
+  std::cout << ( countOnly ? "Counted " : "Generated " ) << count << " points" << std::endl;
+  return count;
 }
 
 void Sample::meshToPcFace( const Model& input,
@@ -144,53 +370,45 @@ void Sample::meshToPcFace( const Model& input,
                            bool         bilinear,
                            bool         logProgress,
                            size_t&      computedResolution ) {
-  size_t resolution = 1024;
-  meshToPcFace( input, output, tex_map, resolution, thickness, bilinear, logProgress );
-  // search to init the algo bounds
-  size_t minResolution = 0;
-  size_t maxResolution = 0;
-  //
+  // the step of the estimate follows the one of the sampler
+  glm::vec3 minPos, maxPos;
+  Geometry::computeBBox( input.vertices, minPos, maxPos );
+  const glm::vec3 diag       = maxPos - minPos;
+  const float     boxMaxSize = std::max( diag.x, std::max( diag.y, diag.z ) );
+  auto            estimate   = [&]( double density ) {
+    const float step = boxMaxSize / (float)density;
+    return estimateModelPointCount( input, [&]( const Vertex& v1, const Vertex& v2, const Vertex& v3 ) {
+      return estimateFaceCount( v1, v2, v3, step, thickness );
+    } );
+  };
+  auto count = [&]( double density ) {
+    std::cout << "  resolution=" << (size_t)density << std::endl;
+    return meshToPcFace( input, output, tex_map, (size_t)density, thickness, bilinear, logProgress, true );
+  };
   size_t iter = 0;
-  while ( ( output.getPositionCount() < nbSamplesMin || output.getPositionCount() > nbSamplesMax )
-          && iter < maxIterations ) {
-    iter++;
-    // let's refine
-    if ( output.getPositionCount() < nbSamplesMin ) {  // need to add some points
-      minResolution = resolution;
-      if ( maxResolution == 0 ) {
-        resolution = minResolution * 2;
-      } else {
-        resolution = minResolution + ( maxResolution - minResolution ) / 2;
-      }
-    }
-    if ( output.getPositionCount() > nbSamplesMax ) {  // need to remove some points
-      maxResolution = resolution;
-      resolution    = minResolution + ( maxResolution - minResolution ) / 2;
-    }
-    std::cout << "  posCount=" << output.getPositionCount() << std::endl;
-    std::cout << "  minResolution=" << minResolution << std::endl;
-    std::cout << "  maxResolution=" << maxResolution << std::endl;
-    std::cout << "  resolution=" << resolution << std::endl;
-    //
-    output.reset();
-    meshToPcFace( input, output, tex_map, resolution, thickness, bilinear, logProgress );
-  }
-  computedResolution = resolution;
+  computedResolution =
+    (size_t)searchDensity( 1024.0, 1.0, true, nbSamplesMin, nbSamplesMax, maxIterations, estimate, count, iter );
   std::cout << "algorithm ended after " << iter << " iterations " << std::endl;
+  // the model is only generated at the resolution found
+  output.reset();
+  meshToPcFace( input, output, tex_map, computedResolution, thickness, bilinear, logProgress );
 }
 
-// we use ray tracing to process the result, we could also use a rasterization (might be faster)
-void Sample::meshToPcGrid( const Model& input,
-                           Model&       output,
-                           const Image& tex_map,
-                           const size_t resolution,
-                           const bool   bilinear,
-                           const bool   logProgress,
-                           bool         useNormal,
-                           bool         useFixedPoint,
-                           glm::vec3&   minPos,
-                           glm::vec3&   maxPos,
-                           const bool   verbose ) {
+// we use ray tracing to process the result, or a rasterization of the triangles projected
+// on the three planes of the grid, which only visits the covered cells
+size_t Sample::meshToPcGrid( const Model& input,
+                             Model&       output,
+                             const Image& tex_map,
+                             const size_t resolution,
+                             const bool   bilinear,
+                             const bool   logProgress,
+                             bool         useNormal,
+                             bool         useFixedPoint,
+                             bool         useRaster,
+                             glm::vec3&   minPos,
+                             glm::vec3&   maxPos,
+                             const bool   verbose,
+                             const bool   countOnly ) {
   // computes the bounding box of the vertices
   glm::vec3     minBox       = minPos;
   glm::vec3     maxBox       = maxPos;
@@ -246,147 +464,260 @@ void Sample::meshToPcGrid( const Model& input,
   // we will now sample between min and max over the three dimensions, using resolution
   // by throwing rays from the three orthogonal faces of the box XY, XZ, YZ
 
-  // to prevent storing duplicate points, we use a ModelBuilder
-  ModelBuilder builder( output );
+  // to prevent storing duplicate points, we use a ModelBuilder per block of triangles.
+  // blocks are sampled concurrently and merged in triangle order.
+  const size_t         triangleCount = input.triangles.size() / 3;
+  const size_t         blockSize     = 256;
+  const int64_t        blockCount    = ( triangleCount + blockSize - 1 ) / blockSize;
+  // counts compare the colors of the texture map through the uv of the points
+  const bool           textured      = input.uvcoords.size() != 0 && tex_map.data != NULL;
+  ParallelModelBuilder builder( blockCount, countOnly && textured ? &tex_map : NULL, bilinear );
 
   size_t skipped = 0;  // number of degenerate triangles
 
-  // for each triangle
-  for ( size_t triIdx = 0; triIdx < input.triangles.size() / 3; ++triIdx ) {
-    if ( logProgress ) std::cout << '\r' << triIdx << "/" << input.triangles.size() / 3 << std::flush;
+  // adds a point of the triangle (v1, v2, v3), (u,v) being the barycentrics of the point
+  auto pushSample = [&]( int64_t          block,
+                         const Vertex&    v1,
+                         const Vertex&    v2,
+                         const Vertex&    v3,
+                         const glm::vec3& normal,
+                         const glm::vec3& pos,
+                         float            u,
+                         float            v ) {
+    // we convert the result into a point with color
+    Vertex vertex;
+    vertex.pos       = pos;
+    vertex.nrm       = normal;
+    vertex.hasNormal = true;
 
-    Vertex v1, v2, v3;
+    // compute the color fi any
+    // use the texture map
+    if ( input.uvcoords.size() != 0 && tex_map.data != NULL ) {
+      // use barycentric coordinates to extract point UV
+      glm::vec2 uv = v1.uv * ( 1.0f - u - v ) + v2.uv * u + v3.uv * v;
 
-    fetchTriangle(
-      input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
+      // fetch the color from the map, a count keeps the uv for the builder to fetch the colors it compares
+      if ( countOnly ) vertex.uv = uv;
+      else if ( bilinear ) texture2D_bilinear( tex_map, uv, vertex.col );
+      else texture2D( tex_map, uv, vertex.col );
 
-    // check if triangle is not degenerate
-    if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
-      ++skipped;
-      continue;
+      vertex.hasColor = true;
+    }
+    // use color per vertex
+    else if ( input.colors.size() != 0 ) {
+      // compute pixel color using barycentric coordinates
+      vertex.col      = v1.col * ( 1.0f - u - v ) + v2.col * u + v3.col * v;
+      vertex.hasColor = true;
     }
 
-    // compute face normal
-    glm::vec3 normal;
-    Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
+    // add the vertex
+    builder.pushVertex( block, vertex );
+  };
 
-    // extract the triangle bbox
-    glm::vec3 triMinBox, triMaxBox;
-    Geometry::triangleBBox( v1.pos, v2.pos, v3.pos, triMinBox, triMaxBox );
-
-    // now find the Discrete range from global box to triangle box
-    glm::vec3 lmin =
-      glm::floor( ( triMinBox - minBox ) / stepSize );  // can lead to division by zero with flat box, handled later
-    glm::vec3 lmax = glm::ceil( ( triMaxBox - minBox ) / stepSize );  // idem
-    glm::vec3 lcnt = lmax - lmin;
-
-    // now we will send rays on this triangle from the discreet steps of this box
-    // rayTrace from the three main axis
-
-    // reordering the search to start with the direction closest to the triangle normal
-    glm::ivec3 mainAxisVector( 0, 1, 2 );
-    // we want to preserve invariance with existing references if useNormal is disabled
-    // so we do the following reordering only if option is enabled
-    if ( useNormal ) {
-      if ( ( std::abs( normal[0] ) >= std::abs( normal[1] ) ) && ( std::abs( normal[0] ) >= std::abs( normal[2] ) ) ) {
-        if ( std::abs( normal[1] ) >= std::abs( normal[2] ) ) mainAxisVector = glm::ivec3( 0, 1, 2 );
-        else mainAxisVector = glm::ivec3( 0, 2, 1 );
-      } else {
-        if ( ( std::abs( normal[1] ) >= std::abs( normal[0] ) )
-             && ( std::abs( normal[1] ) >= std::abs( normal[2] ) ) ) {
-          if ( std::abs( normal[0] ) >= std::abs( normal[2] ) ) mainAxisVector = glm::ivec3( 1, 0, 2 );
-          else mainAxisVector = glm::ivec3( 1, 2, 0 );
-        } else {
-          if ( std::abs( normal[0] ) >= std::abs( normal[1] ) ) mainAxisVector = glm::ivec3( 2, 0, 1 );
-          else mainAxisVector = glm::ivec3( 2, 1, 0 );
-        }
-      }
-    }
-    int mainAxisMaxIndex = useNormal ? 1 : 3;  // if useNormal is selected, we only need to check the first index
-
-    for ( int mainAxisIndex = 0; mainAxisIndex < mainAxisMaxIndex; ++mainAxisIndex ) {
-      glm::vec3::length_type mainAxis = mainAxisVector[mainAxisIndex];
-      // axis swizzling
-      glm::vec3::length_type secondAxis = 1;
-      glm::vec3::length_type thirdAxis  = 2;
-      if ( mainAxis == 1 ) {
-        secondAxis = 0;
-        thirdAxis  = 2;
-      } else if ( mainAxis == 2 ) {
-        secondAxis = 0;
-        thirdAxis  = 1;
+  // for each triangle
+#pragma omp parallel for reduction( + : skipped ) schedule( dynamic )
+  for ( int64_t block = 0; block < blockCount; ++block ) {
+    // planning pass, the block is sized for the estimated point count of its triangles
+    auto estimate = [&]( const Vertex& v1, const Vertex& v2, const Vertex& v3 ) {
+      return estimateGridCount( v1, v2, v3, stepSize[0], useNormal );
+    };
+    const size_t blockEnd = std::min( triangleCount, ( block + 1 ) * blockSize );
+    builder.reserve( block, estimatePointCount( input, block * blockSize, blockEnd, estimate ) );
+    // rays of a row and their results, reused for the triangles of the block
+    std::vector<float>   rowOrigins[3], rowT, rowU, rowV;
+    std::vector<uint8_t> rowHits;
+    // face normals of the block
+    std::vector<glm::vec3> normals;
+    computeBlockNormals( input, block * blockSize, blockEnd, normals );
+    for ( size_t triIdx = block * blockSize; triIdx < blockEnd; ++triIdx ) {
+      if ( logProgress ) {
+#pragma omp critical
+        std::cout << '\r' << triIdx << "/" << triangleCount << std::flush;
       }
 
-      // skip this axis if box is null sized on one of the two other axis
-      if ( minBox[secondAxis] == maxBox[secondAxis] || minBox[thirdAxis] == maxBox[thirdAxis] ) continue;
+      Vertex v1, v2, v3;
 
-      // let's throw from mainAxis prependicular plane
-      glm::vec3 rayOrigin    = { 0.0, 0.0, 0.0 };
-      glm::vec3 rayDirection = { 0.0, 0.0, 0.0 };
+      fetchTriangle(
+        input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
 
-      // on the main axis
-      if ( stepSize[mainAxis] == 0.0F ) {  // handle stepSize[axis]==0
-        // add small thress to be sure ray intersect in positive t
-        rayOrigin[mainAxis] = minBox[mainAxis] - 0.5F;
-      } else {
-        rayOrigin[mainAxis] = minBox[mainAxis] + lmin[mainAxis] * stepSize[mainAxis];
+      // check if triangle is not degenerate
+      if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
+        ++skipped;
+        continue;
       }
-      // on main axis from min to max
-      rayDirection[mainAxis] = 1.0;
-
-      // iterate the second axis with i
-      for ( size_t i = 0; i <= lcnt[secondAxis]; ++i ) {
-        // iterate the third axis with j
-        for ( size_t j = 0; j <= lcnt[thirdAxis]; ++j ) {
-          // create the ray, starting from the face of the triangle bbox
-          rayOrigin[secondAxis] = minBox[secondAxis] + ( lmin[secondAxis] + i ) * stepSize[secondAxis];
-          rayOrigin[thirdAxis]  = minBox[thirdAxis] + ( lmin[thirdAxis] + j ) * stepSize[thirdAxis];
-
-          //  triplet, x = t, y = u, z = v with t the parametric and (u,v) the barycentrics
-          glm::vec3 res;
-
-          // let' throw the ray toward the triangle
-          if ( Geometry::evalRayTriangle( rayOrigin, rayDirection, v1.pos, v2.pos, v3.pos, res ) ) {
-            // we convert the result into a point with color
-            Vertex v;
-            v.pos       = rayOrigin + rayDirection * res[0];
-            v.nrm       = normal;
-            v.hasNormal = true;
 
-            // compute the color fi any
-            // use the texture map
-            if ( input.uvcoords.size() != 0 && tex_map.data != NULL ) {
-              // use barycentric coordinates to extract point UV
-              glm::vec2 uv = v1.uv * ( 1.0f - res.y - res.z ) + v2.uv * res.y + v3.uv * res.z;
+      // face normal
+      const glm::vec3& normal = normals[triIdx - block * blockSize];
+
+      // extract the triangle bbox
+      glm::vec3 triMinBox, triMaxBox;
+      Geometry::triangleBBox( v1.pos, v2.pos, v3.pos, triMinBox, triMaxBox );
+
+      // now find the Discrete range from global box to triangle box
+      glm::vec3 lmin =
+        glm::floor( ( triMinBox - minBox ) / stepSize );  // can lead to division by zero with flat box, handled later
+      glm::vec3 lmax = glm::ceil( ( triMaxBox - minBox ) / stepSize );  // idem
+      glm::vec3 lcnt = lmax - lmin;
+
+      // now we will send rays on this triangle from the discreet steps of this box
+      // rayTrace from the three main axis
+
+      // reordering the search to start with the direction closest to the triangle normal
+      glm::ivec3 mainAxisVector( 0, 1, 2 );
+      // we want to preserve invariance with existing references if useNormal is disabled
+      // so we do the following reordering only if option is enabled
+      if ( useNormal ) {
+        if ( ( std::abs( normal[0] ) >= std::abs( normal[1] ) )
+             && ( std::abs( normal[0] ) >= std::abs( normal[2] ) ) ) {
+          if ( std::abs( normal[1] ) >= std::abs( normal[2] ) ) mainAxisVector = glm::ivec3( 0, 1, 2 );
+          else mainAxisVector = glm::ivec3( 0, 2, 1 );
+        } else {
+          if ( ( std::abs( normal[1] ) >= std::abs( normal[0] ) )
+               && ( std::abs( normal[1] ) >= std::abs( normal[2] ) ) ) {
+            if ( std::abs( normal[0] ) >= std::abs( normal[2] ) ) mainAxisVector = glm::ivec3( 1, 0, 2 );
+            else mainAxisVector = glm::ivec3( 1, 2, 0 );
+          } else {
+            if ( std::abs( normal[0] ) >= std::abs( normal[1] ) ) mainAxisVector = glm::ivec3( 2, 0, 1 );
+            else mainAxisVector = glm::ivec3( 2, 1, 0 );
+          }
+        }
+      }
+      int mainAxisMaxIndex = useNormal ? 1 : 3;  // if useNormal is selected, we only need to check the first index
+
+      for ( int mainAxisIndex = 0; mainAxisIndex < mainAxisMaxIndex; ++mainAxisIndex ) {
+        glm::vec3::length_type mainAxis = mainAxisVector[mainAxisIndex];
+        // axis swizzling
+        glm::vec3::length_type secondAxis = 1;
+        glm::vec3::length_type thirdAxis  = 2;
+        if ( mainAxis == 1 ) {
+          secondAxis = 0;
+          thirdAxis  = 2;
+        } else if ( mainAxis == 2 ) {
+          secondAxis = 0;
+          thirdAxis  = 1;
+        }
 
-              // fetch the color from the map
-              if ( bilinear ) texture2D_bilinear( tex_map, uv, v.col );
-              else texture2D( tex_map, uv, v.col );
+        // skip this axis if box is null sized on one of the two other axis
+        if ( minBox[secondAxis] == maxBox[secondAxis] || minBox[thirdAxis] == maxBox[thirdAxis] ) continue;
 
-              v.hasColor = true;
-              // v.col = v.col * rayDirection; --> for debugging, paints the color of the vertex according to the
-              // direction
-            }
-            // use color per vertex
-            else if ( input.colors.size() != 0 ) {
-              // compute pixel color using barycentric coordinates
-              v.col      = v1.col * ( 1.0f - res.y - res.z ) + v2.col * res.y + v3.col * res.z;
-              v.hasColor = true;
+        // let's throw from mainAxis prependicular plane
+        glm::vec3 rayOrigin    = { 0.0, 0.0, 0.0 };
+        glm::vec3 rayDirection = { 0.0, 0.0, 0.0 };
+
+        // on the main axis
+        if ( stepSize[mainAxis] == 0.0F ) {  // handle stepSize[axis]==0
+          // add small thress to be sure ray intersect in positive t
+          rayOrigin[mainAxis] = minBox[mainAxis] - 0.5F;
+        } else {
+          rayOrigin[mainAxis] = minBox[mainAxis] + lmin[mainAxis] * stepSize[mainAxis];
+        }
+        // on main axis from min to max
+        rayDirection[mainAxis] = 1.0;
+
+        if ( !useRaster ) {
+          // the rays of a row of the third axis are thrown as a batch
+          const size_t rowSize = (size_t)lcnt[thirdAxis] + 1;
+          for ( auto& origin : rowOrigins ) origin.resize( rowSize );
+          rowT.resize( rowSize );
+          rowU.resize( rowSize );
+          rowV.resize( rowSize );
+          rowHits.resize( rowSize );
+          std::fill( rowOrigins[mainAxis].begin(), rowOrigins[mainAxis].end(), rayOrigin[mainAxis] );
+          for ( size_t j = 0; j < rowSize; ++j ) {
+            rowOrigins[thirdAxis][j] = minBox[thirdAxis] + ( lmin[thirdAxis] + j ) * stepSize[thirdAxis];
+          }
+          // iterate the second axis with i
+          for ( size_t i = 0; i <= lcnt[secondAxis]; ++i ) {
+            // create the rays, starting from the face of the triangle bbox
+            rayOrigin[secondAxis] = minBox[secondAxis] + ( lmin[secondAxis] + i ) * stepSize[secondAxis];
+            std::fill( rowOrigins[secondAxis].begin(), rowOrigins[secondAxis].end(), rayOrigin[secondAxis] );
+
+            // let' throw the rays toward the triangle, t the parametric and (u,v) the barycentrics
+            if ( Geometry::evalRayTriangleBatch( rayDirection,
+                                                 rowSize,
+                                                 rowOrigins[0].data(),
+                                                 rowOrigins[1].data(),
+                                                 rowOrigins[2].data(),
+                                                 v1.pos,
+                                                 v2.pos,
+                                                 v3.pos,
+                                                 rowT.data(),
+                                                 rowU.data(),
+                                                 rowV.data(),
+                                                 rowHits.data() ) == 0 )
+              continue;
+            // iterate the third axis with j
+            for ( size_t j = 0; j < rowSize; ++j ) {
+              if ( !rowHits[j] ) continue;
+              rayOrigin[thirdAxis] = rowOrigins[thirdAxis][j];
+              pushSample( block, v1, v2, v3, normal, rayOrigin + rayDirection * rowT[j], rowU[j], rowV[j] );
             }
+          }
+          continue;
+        }
 
-            // add the vertex
-            builder.pushVertex( v );
+        // rasterization of the triangle projected on the plane of the second and third axis.
+        // the barycentrics (u,v) of a cell center are given by the 2D edge functions of the triangle.
+        const glm::vec2 p0( v1.pos[secondAxis], v1.pos[thirdAxis] );
+        const glm::vec2 e1  = glm::vec2( v2.pos[secondAxis], v2.pos[thirdAxis] ) - p0;
+        const glm::vec2 e2  = glm::vec2( v3.pos[secondAxis], v3.pos[thirdAxis] ) - p0;
+        const float     det = e1.x * e2.y - e1.y * e2.x;
+        // the triangle is parallel to the rays, as rejected by evalRayTriangle
+        if ( det > -ZERO_TOLERANCE && det < ZERO_TOLERANCE ) continue;
+        const float invDet = 1.0f / det;
+        const float step   = stepSize[thirdAxis];
+        for ( size_t i = 0; i <= lcnt[secondAxis]; ++i ) {
+          const float x  = minBox[secondAxis] + ( lmin[secondAxis] + i ) * stepSize[secondAxis];
+          const float dx = x - p0.x;
+          // along the row u, v and 1-u-v are affine in j, the walk is restricted to the j where the three
+          // are positive, with a margin of one cell for rounding errors, the cells are then tested exactly
+          const float dy0 = minBox[thirdAxis] + lmin[thirdAxis] * step - p0.y;
+          const float au  = ( dx * e2.y - dy0 * e2.x ) * invDet;
+          const float bu  = -step * e2.x * invDet;
+          const float av  = ( e1.x * dy0 - e1.y * dx ) * invDet;
+          const float bv  = step * e1.x * invDet;
+          float       lo  = 0.0f;
+          float       hi  = lcnt[thirdAxis];
+          auto        clip = [&]( float a, float b ) {
+            if ( b > 0.0f ) lo = std::max( lo, std::floor( -a / b ) - 1.0f );
+            else if ( b < 0.0f ) hi = std::min( hi, std::ceil( -a / b ) + 1.0f );
+          };
+          clip( au, bu );
+          clip( av, bv );
+          clip( 1.0f - au - av, -bu - bv );
+          if ( !( lo <= hi ) ) continue;
+          for ( size_t j = (size_t)lo; j <= (size_t)hi; ++j ) {
+            const float y  = minBox[thirdAxis] + ( lmin[thirdAxis] + j ) * step;
+            const float dy = y - p0.y;
+            const float u  = ( dx * e2.y - dy * e2.x ) * invDet;
+            if ( u < 0.0f || u > 1.0f ) continue;
+            const float v = ( e1.x * dy - e1.y * dx ) * invDet;
+            if ( v < 0.0f || u + v > 1.0f ) continue;
+            // depth of the cell on the triangle plane
+            glm::vec3 pos;
+            pos[mainAxis]   = v1.pos[mainAxis] + u * ( v2.pos[mainAxis] - v1.pos[mainAxis] )
+                            + v * ( v3.pos[mainAxis] - v1.pos[mainAxis] );
+            pos[secondAxis] = x;
+            pos[thirdAxis]  = y;
+            pushSample( block, v1, v2, v3, normal, pos, u, v );
           }
         }
       }
     }
   }
+  size_t count = 0;
+  if ( countOnly ) count = builder.count();
+  else {
+    builder.merge( output );
+    count = output.vertices.size() / 3;
+  }
   if ( logProgress ) std::cout << std::endl;
   if ( verbose ) {
     if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
     if ( builder.foundCount != 0 ) std::cout << "Skipped " << builder.foundCount << " duplicate vertices" << std::endl;
-    std::cout << "Generated " << output.vertices.size() / 3 << " points" << std::endl;
+    std::cout << ( countOnly ? "Counted " : "Generated " ) << count << " points" << std::endl;
   }
+  return count;
 }
 
 void Sample::meshToPcGrid( const Model& input,
@@ -399,42 +730,54 @@ void Sample::meshToPcGrid( const Model& input,
                            bool         logProgress,
                            bool         useNormal,
                            bool         useFixedPoint,
+                           bool         useRaster,
                            glm::vec3&   minPos,
                            glm::vec3&   maxPos,
                            size_t&      computedResolution ) {
-  size_t resolution = 1024;
-  meshToPcGrid( input, output, tex_map, resolution, bilinear, logProgress, useNormal, useFixedPoint, minPos, maxPos );
-  // search to init the algo bounds
-  size_t minResolution = 0;
-  size_t maxResolution = 0;
-  //
+  // the step of the estimate follows the one of the sampler
+  glm::vec3 minBox = minPos, maxBox = maxPos;
+  if ( minPos == maxPos ) Geometry::computeBBox( input.vertices, minBox, maxBox );
+  const glm::vec3 diag     = maxBox - minBox;
+  const float     range    = std::max( diag.x, std::max( diag.y, diag.z ) );
+  auto            estimate = [&]( double density ) {
+    const float step = range / (float)( density - 1.0 );
+    return estimateModelPointCount( input, [&]( const Vertex& v1, const Vertex& v2, const Vertex& v3 ) {
+      return estimateGridCount( v1, v2, v3, step, useNormal );
+    } );
+  };
+  auto count = [&]( double density ) {
+    std::cout << "  resolution=" << (size_t)density << std::endl;
+    return meshToPcGrid( input,
+                         output,
+                         tex_map,
+                         (size_t)density,
+                         bilinear,
+                         logProgress,
+                         useNormal,
+                         useFixedPoint,
+                         useRaster,
+                         minPos,
+                         maxPos,
+                         true,
+                         true );
+  };
   size_t iter = 0;
-  while ( ( output.getPositionCount() < nbSamplesMin || output.getPositionCount() > nbSamplesMax )
-          && iter < maxIterations ) {
-    iter++;
-    // let's refine
-    if ( output.getPositionCount() < nbSamplesMin ) {  // need to add some points
-      minResolution = resolution;
-      if ( maxResolution == 0 ) {
-        resolution = minResolution * 2;
-      } else {
-        resolution = minResolution + ( maxResolution - minResolution ) / 2;
-      }
-    }
-    if ( output.getPositionCount() > nbSamplesMax ) {  // need to remove some points
-      maxResolution = resolution;
-      resolution    = minResolution + ( maxResolution - minResolution ) / 2;
-    }
-    std::cout << "  posCount=" << output.getPositionCount() << std::endl;
-    std::cout << "  minResolution=" << minResolution << std::endl;
-    std::cout << "  maxResolution=" << maxResolution << std::endl;
-    std::cout << "  resolution=" << resolution << std::endl;
-    //
-    output.reset();
-    meshToPcGrid( input, output, tex_map, resolution, bilinear, logProgress, useNormal, useFixedPoint, minPos, maxPos );
-  }
-  computedResolution = resolution;
+  computedResolution =
+    (size_t)searchDensity( 1024.0, 2.0, true, nbSamplesMin, nbSamplesMax, maxIterations, estimate, count, iter );
   std::cout << "algorithm ended after " << iter << " iterations " << std::endl;
+  // the model is only generated at the resolution found
+  output.reset();
+  meshToPcGrid( input,
+                output,
+                tex_map,
+                computedResolution,
+                bilinear,
+                logProgress,
+                useNormal,
+                useFixedPoint,
+                useRaster,
+                minPos,
+                maxPos );
 }
 
 // perform a reverse sampling of the texture map to generate mesh samples
@@ -519,123 +862,231 @@ void Sample::meshToPcMap( const Model& input, Model& output, const Image& tex_ma
   std::cout << "Generated " << output.vertices.size() / 3 << " points" << std::endl;
 }
 
-// recursive body of meshtoPvDiv
-void subdivideTriangle( const Vertex& v1,
-                        const Vertex& v2,
-                        const Vertex& v3,
-                        const Image&  tex_map,
-                        const float   thres,
-                        const bool    mapThreshold,
-                        const bool    bilinear,
-                        ModelBuilder& output ) {
-  // recursion stop criterion on area
-  bool areaReached = Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < thres;
-
-  // recursion stop criterion on texels adjacency
-  if ( mapThreshold && tex_map.data != NULL ) {
-    const glm::ivec2 mapSize = { tex_map.width, tex_map.height };
-    glm::ivec2       mapCoord1, mapCoord2, mapCoord3;
-    mapCoordClamped( v1.uv, mapSize, mapCoord1 );
-    mapCoordClamped( v2.uv, mapSize, mapCoord2 );
-    mapCoordClamped( v3.uv, mapSize, mapCoord3 );
-    if ( std::abs( mapCoord1.x - mapCoord2.x ) <= 1 && std::abs( mapCoord1.x - mapCoord3.x ) <= 1
-         && std::abs( mapCoord2.x - mapCoord3.x ) <= 1 && std::abs( mapCoord1.y - mapCoord2.y ) <= 1
-         && std::abs( mapCoord1.y - mapCoord3.y ) <= 1 && std::abs( mapCoord2.y - mapCoord3.y ) <= 1 && areaReached ) {
-      return;
+namespace {
+
+// vertices generated by the subdivision of one triangle. the edges are identified by the indices of their
+// two vertices so that the midpoint of an edge shared by two sub triangles is computed, and its color
+// fetched from the map, only once. counts fetch no color, the uv of the vertices is in their keys and tells
+// their colors apart.
+class SubdivisionVertices {
+ public:
+  SubdivisionVertices( const Image& tex_map, const bool bilinear, const bool countOnly )
+      : _tex_map( tex_map ), _bilinear( bilinear ), _countOnly( countOnly ) {}
+
+  // restarts with the vertices of a new triangle, of indices 0, 1 and 2
+  void reset( const Vertex& v1, const Vertex& v2, const Vertex& v3 ) {
+    _vertices.clear();
+    _colors.clear();
+    _midpoints.clear();
+    add( v1 );
+    add( v2 );
+    add( v3 );
+  }
+
+  inline const Vertex& operator[]( const uint32_t index ) const { return _vertices[index]; }
+
+  // returns the index of the midpoint of the edge (a,b), computed as (a+b)*0.5 if sumFirst, a*0.5+b*0.5 otherwise.
+  // both are symmetric, the midpoint does not depend on the orientation of the edge.
+  uint32_t midpoint( const uint32_t a, const uint32_t b, const bool sumFirst ) {
+    const uint64_t key = a < b ? ( (uint64_t)a << 32 ) | b : ( (uint64_t)b << 32 ) | a;
+    const auto     it  = _midpoints.find( key );
+    if ( it != _midpoints.end() ) return it->second;
+    const Vertex& v1 = _vertices[a];
+    const Vertex& v2 = _vertices[b];
+    // we use v1 as reference in term of components to push
+    Vertex e;
+    e.hasColor   = v1.hasColor;
+    e.hasUVCoord = v1.hasUVCoord;
+    if ( sumFirst ) {
+      e.pos = ( v1.pos + v2.pos ) * 0.5F;
+      e.col = ( v1.col + v2.col ) * 0.5F;
+      e.uv  = ( v1.uv + v2.uv ) * 0.5F;
+    } else {
+      e.pos = v1.pos * 0.5F + v2.pos * 0.5F;
+      e.col = v1.col * 0.5F + v2.col * 0.5F;
+      e.uv  = v1.uv * 0.5F + v2.uv * 0.5F;
+    }
+    const uint32_t index = (uint32_t)_vertices.size();
+    add( e );
+    _midpoints.emplace( key, index );
+    return index;
+  }
+
+  // same as builder.pushVertex( block, vertex, tex_map, bilinear ) with vertex forced to the face normal
+  inline void push( ParallelModelBuilder& builder,
+                    const size_t          block,
+                    const uint32_t        index,
+                    const glm::vec3&      normal ) const {
+    Vertex v    = _vertices[index];
+    v.nrm       = normal;
+    v.hasNormal = true;
+    if ( v.hasUVCoord && _tex_map.data != NULL ) {
+      v.col        = _colors[index];
+      v.hasUVCoord = false;
+      v.hasColor   = true;
+    }
+    builder.pushVertex( block, v );
+  }
+
+ private:
+  void add( const Vertex& v ) {
+    _vertices.push_back( v );
+    _colors.emplace_back( 0.0F );
+    if ( v.hasUVCoord && _tex_map.data != NULL && !_countOnly ) {
+      // fetch the color from the map
+      if ( _bilinear ) texture2D_bilinear( _tex_map, v.uv, _colors.back() );
+      else texture2D( _tex_map, v.uv, _colors.back() );
     }
-  } else if ( areaReached ) {
-    return;
   }
 
-  //
-  glm::vec3 normal;
-  Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
-
-  // the new vertices
-  Vertex e1, e2, e3;
-  // we sue v1 as reference in term of components to push
-  e1.hasColor = e2.hasColor = e3.hasColor = v1.hasColor;
-  e1.hasUVCoord = e2.hasUVCoord = e3.hasUVCoord = v1.hasUVCoord;
-  // forces normals, we use generated per face ones - might be better as an option
-  e1.hasNormal = e2.hasNormal = e3.hasNormal = true;
-
-  // edge centers
-  // (we do not interpolate normals but use face normal) - might be better as an option
-  e1.pos = v1.pos * 0.5F + v2.pos * 0.5F;
-  e1.col = v1.col * 0.5F + v2.col * 0.5F;
-  e1.uv  = v1.uv * 0.5F + v2.uv * 0.5F;
-  e1.nrm = normal;
-
-  e2.pos = v2.pos * 0.5F + v3.pos * 0.5F;
-  e2.col = v2.col * 0.5F + v3.col * 0.5F;
-  e2.uv  = v2.uv * 0.5F + v3.uv * 0.5F;
-  e2.nrm = normal;
-
-  e3.pos = v3.pos * 0.5F + v1.pos * 0.5F;
-  e3.col = v3.col * 0.5F + v1.col * 0.5F;
-  e3.uv  = v3.uv * 0.5F + v1.uv * 0.5F;
-  e3.nrm = normal;
-
-  // push the new vertices
-  output.pushVertex( e1, tex_map, bilinear );
-  output.pushVertex( e2, tex_map, bilinear );
-  output.pushVertex( e3, tex_map, bilinear );
-
-  // go deeper in the subdivision
-  subdivideTriangle( e1, e2, e3, tex_map, thres, mapThreshold, bilinear, output );
-  subdivideTriangle( v1, e1, e3, tex_map, thres, mapThreshold, bilinear, output );
-  subdivideTriangle( e1, v2, e2, tex_map, thres, mapThreshold, bilinear, output );
-  subdivideTriangle( e2, v3, e3, tex_map, thres, mapThreshold, bilinear, output );
+  const Image&                           _tex_map;
+  const bool                             _bilinear;
+  const bool                             _countOnly;
+  std::vector<Vertex>                    _vertices;
+  std::vector<glm::vec3>                 _colors;  // fetched from the map
+  std::unordered_map<uint64_t, uint32_t> _midpoints;
+};
+
+// a triangle of the subdivision, indices in SubdivisionVertices
+struct SubdivisionTriangle {
+  uint32_t v1, v2, v3;
+};
+
+}  // namespace
+
+// body of meshtoPvDiv, subdivides the triangle (0,1,2) of vertices.
+// the sub triangles are processed depth first with an explicit stack, in the order of the original recursion
+void subdivideTriangle( SubdivisionVertices&              vertices,
+                        std::vector<SubdivisionTriangle>& stack,
+                        const Image&                      tex_map,
+                        const float                       thres,
+                        const bool                        mapThreshold,
+                        ParallelModelBuilder&             output,
+                        const size_t                      block ) {
+  stack.clear();
+  stack.push_back( { 0, 1, 2 } );
+  while ( !stack.empty() ) {
+    const SubdivisionTriangle tri = stack.back();
+    stack.pop_back();
+    const glm::vec3 p1 = vertices[tri.v1].pos, p2 = vertices[tri.v2].pos, p3 = vertices[tri.v3].pos;
+
+    // subdivision stop criterion on area
+    bool areaReached = Geometry::triangleArea( p1, p2, p3 ) < thres;
+
+    // subdivision stop criterion on texels adjacency
+    if ( mapThreshold && tex_map.data != NULL ) {
+      const glm::ivec2 mapSize = { tex_map.width, tex_map.height };
+      glm::ivec2       mapCoord1, mapCoord2, mapCoord3;
+      mapCoordClamped( vertices[tri.v1].uv, mapSize, mapCoord1 );
+      mapCoordClamped( vertices[tri.v2].uv, mapSize, mapCoord2 );
+      mapCoordClamped( vertices[tri.v3].uv, mapSize, mapCoord3 );
+      if ( std::abs( mapCoord1.x - mapCoord2.x ) <= 1 && std::abs( mapCoord1.x - mapCoord3.x ) <= 1
+           && std::abs( mapCoord2.x - mapCoord3.x ) <= 1 && std::abs( mapCoord1.y - mapCoord2.y ) <= 1
+           && std::abs( mapCoord1.y - mapCoord3.y ) <= 1 && std::abs( mapCoord2.y - mapCoord3.y ) <= 1
+           && areaReached ) {
+        continue;
+      }
+    } else if ( areaReached ) {
+      continue;
+    }
+
+    //
+    glm::vec3 normal;
+    Geometry::triangleNormal( p1, p2, p3, normal );
+
+    // edge centers
+    // (we do not interpolate normals but use face normal) - might be better as an option
+    const uint32_t e1 = vertices.midpoint( tri.v1, tri.v2, false );
+    const uint32_t e2 = vertices.midpoint( tri.v2, tri.v3, false );
+    const uint32_t e3 = vertices.midpoint( tri.v3, tri.v1, false );
+
+    // push the new vertices
+    vertices.push( output, block, e1, normal );
+    vertices.push( output, block, e2, normal );
+    vertices.push( output, block, e3, normal );
+
+    // go deeper in the subdivision, last sub triangle on the stack is processed first
+    stack.push_back( { e2, tri.v3, e3 } );
+    stack.push_back( { e1, tri.v2, e2 } );
+    stack.push_back( { tri.v1, e1, e3 } );
+    stack.push_back( { e1, e2, e3 } );
+  }
 }
 
 // Use triangle subdivision algorithm to perform the sampling
 // Use simple subdiv scheme, stop criterion on triangle area or texture sample distance <= 1 pixel
-void Sample::meshToPcDiv( const Model& input,
-                          Model&       output,
-                          const Image& tex_map,
-                          float        areaThreshold,
-                          bool         mapThreshold,
-                          bool         bilinear,
-                          bool         logProgress ) {
+size_t Sample::meshToPcDiv( const Model& input,
+                            Model&       output,
+                            const Image& tex_map,
+                            float        areaThreshold,
+                            bool         mapThreshold,
+                            bool         bilinear,
+                            bool         logProgress,
+                            bool         countOnly ) {
   // number of degenerate triangles
   size_t skipped = 0;
 
-  // to prevent storing duplicate points, we use a ModelBuilder
-  ModelBuilder builder( output );
+  // to prevent storing duplicate points, we use a ModelBuilder per block of triangles.
+  // blocks are subdivided concurrently and merged in triangle order.
+  const size_t         triangleCount = input.triangles.size() / 3;
+  const size_t         blockSize     = 256;
+  const int64_t        blockCount    = ( triangleCount + blockSize - 1 ) / blockSize;
+  ParallelModelBuilder builder( blockCount );
 
   // For each triangle
-  for ( size_t triIdx = 0; triIdx < input.triangles.size() / 3; ++triIdx ) {
-    if ( logProgress ) std::cout << '\r' << triIdx << "/" << input.triangles.size() / 3 << std::flush;
+#pragma omp parallel for reduction( + : skipped ) schedule( dynamic )
+  for ( int64_t block = 0; block < blockCount; ++block ) {
+    // planning pass, the block is sized for the estimated point count of its triangles
+    auto estimate = [&]( const Vertex& v1, const Vertex& v2, const Vertex& v3 ) {
+      return estimateDivCount( v1, v2, v3, areaThreshold, mapThreshold ? &tex_map : NULL );
+    };
+    const size_t blockEnd = std::min( triangleCount, ( block + 1 ) * blockSize );
+    builder.reserve( block, estimatePointCount( input, block * blockSize, blockEnd, estimate ) );
+    SubdivisionVertices              vertices( tex_map, bilinear, countOnly );
+    std::vector<SubdivisionTriangle> stack;
+    std::vector<glm::vec3>           normals;
+    computeBlockNormals( input, block * blockSize, blockEnd, normals );
+    for ( size_t triIdx = block * blockSize; triIdx < blockEnd; ++triIdx ) {
+      if ( logProgress ) {
+#pragma omp critical
+        std::cout << '\r' << triIdx << "/" << triangleCount << std::flush;
+      }
 
-    Vertex v1, v2, v3;
+      Vertex v1, v2, v3;
 
-    fetchTriangle(
-      input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
+      fetchTriangle(
+        input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
 
-    // check if triangle is not degenerate
-    if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
-      ++skipped;
-      continue;
-    }
+      // check if triangle is not degenerate
+      if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
+        ++skipped;
+        continue;
+      }
 
-    // compute face normal (forces) - might be better as an option
-    glm::vec3 normal;
-    Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
-    v1.nrm = v2.nrm = v3.nrm = normal;
-    v1.hasNormal = v2.hasNormal = v3.hasNormal = true;
+      // face normal (forces) - might be better as an option
+      const glm::vec3& normal = normals[triIdx - block * blockSize];
 
-    // push the vertices
-    builder.pushVertex( v1, tex_map, bilinear );
-    builder.pushVertex( v2, tex_map, bilinear );
-    builder.pushVertex( v3, tex_map, bilinear );
+      // push the vertices
+      vertices.reset( v1, v2, v3 );
+      vertices.push( builder, block, 0, normal );
+      vertices.push( builder, block, 1, normal );
+      vertices.push( builder, block, 2, normal );
 
-    // subdivide recursively
-    subdivideTriangle( v1, v2, v3, tex_map, areaThreshold, mapThreshold, bilinear, builder );
+      // subdivide
+      subdivideTriangle( vertices, stack, tex_map, areaThreshold, mapThreshold, builder, block );
+    }
+  }
+  size_t count = 0;
+  if ( countOnly ) count = builder.count();
+  else {
+    builder.merge( output );
+    count = output.vertices.size() / 3;
   }
   if ( logProgress ) std::cout << std::endl;
   if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
   if ( builder.foundCount != 0 ) std::cout << "Handled " << builder.foundCount << " duplicate vertices" << std::endl;
-  std::cout << "Generated " << output.vertices.size() / 3 << " points" << std::endl;
+  std::cout << ( countOnly ? "Counted " : "Generated " ) << count << " points" << std::endl;
+  return count;
 }
 
 void Sample::meshToPcDiv( const Model& input,
@@ -647,41 +1098,25 @@ void Sample::meshToPcDiv( const Model& input,
                           bool         bilinear,
                           bool         logProgress,
                           float&       computedThres ) {
-  float value = 1.0;
-  meshToPcDiv( input, output, tex_map, value, 0, bilinear, logProgress );
-  // search to init the algo bounds
-  float minBound = 0;
-  float maxBound = 0;
-  //
-  size_t iter = 0;
-  while ( ( output.getPositionCount() < nbSamplesMin || output.getPositionCount() > nbSamplesMax )
-          && iter < maxIterations ) {
-    iter++;
-    // let's refine
-    if ( output.getPositionCount() > nbSamplesMin ) {  // need to remove some points
-      minBound = value;
-      if ( maxBound == 0 ) {
-        value = minBound * 2;
-      } else {
-        value = minBound + ( maxBound - minBound ) / 2;
-      }
-    }
-    if ( output.getPositionCount() < nbSamplesMax ) {  // need to add some points
-      maxBound = value;
-      value    = minBound + ( maxBound - minBound ) / 2;
-    }
-    std::cout << "  posCount=" << output.getPositionCount() << std::endl;
-    std::cout << "  minBound=" << minBound << std::endl;
-    std::cout << "  maxBound=" << maxBound << std::endl;
-    std::cout << "  value=" << value << std::endl;
-    //
-    output.reset();
-    meshToPcDiv( input, output, tex_map, value, 0, bilinear, logProgress );
-  }
-
-  computedThres = value;
-
+  // the density is the inverse of the area threshold
+  auto estimate = [&]( double density ) {
+    const float areaThreshold = (float)( 1.0 / density );
+    return estimateModelPointCount( input, [&]( const Vertex& v1, const Vertex& v2, const Vertex& v3 ) {
+      return estimateDivCount( v1, v2, v3, areaThreshold, NULL );
+    } );
+  };
+  auto count = [&]( double density ) {
+    std::cout << "  value=" << (float)( 1.0 / density ) << std::endl;
+    return meshToPcDiv( input, output, tex_map, (float)( 1.0 / density ), 0, bilinear, logProgress, true );
+  };
+  size_t       iter    = 0;
+  const double density =
+    searchDensity( 1.0, 0.0, false, nbSamplesMin, nbSamplesMax, maxIterations, estimate, count, iter );
+  computedThres = (float)( 1.0 / density );
   std::cout << "algorithm ended after " << iter << " iterations " << std::endl;
+  // the model is only generated at the threshold found
+  output.reset();
+  meshToPcDiv( input, output, tex_map, computedThres, 0, bilinear, logProgress );
 }
 
 //                      //
@@ -694,119 +1129,104 @@ void Sample::meshToPcDiv( const Model& input,
 //    v1 -------- v3    //
 //          e3          //
 //                      //
-void subdivideTriangleEdge( const Vertex& v1,
-                            const Vertex& v2,
-                            const Vertex& v3,
-                            const Image&  tex_map,
-                            const float   lengthThreshold,
-                            const bool    bilinear,
-                            ModelBuilder& output ) {
-  // the face normal
-  glm::vec3 normal;
-  Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
-
-  // do we split the edges: length(edge)/2 >= threshold
-  const bool split1 = glm::length( v2.pos - v1.pos ) * 0.5F >= lengthThreshold;
-  const bool split2 = glm::length( v2.pos - v3.pos ) * 0.5F >= lengthThreshold;
-  const bool split3 = glm::length( v3.pos - v1.pos ) * 0.5F >= lengthThreshold;
-
-  // early return if threshold reached for each edge
-  if ( !split1 && !split2 && !split3 ) return;
-
-  // the edge centers ~ the potential new vertices
-  Vertex e1, e2, e3;
-  // we use v1 as reference in term of components to push
-  e1.hasColor = e2.hasColor = e3.hasColor = v1.hasColor;
-  e1.hasUVCoord = e2.hasUVCoord = e3.hasUVCoord = v1.hasUVCoord;
-  // forces normals, we use generated per face ones
-  e1.hasNormal = e2.hasNormal = e3.hasNormal = true;
-
-  // compute and push the new edge centers if needed,
-  if ( split1 ) {
-    e1.pos = ( v1.pos + v2.pos ) * 0.5F;
-    e1.col = ( v1.col + v2.col ) * 0.5F;
-    e1.uv  = ( v1.uv + v2.uv ) * 0.5F;
-    e1.nrm = normal;
-    output.pushVertex( e1, tex_map, bilinear );
-  }
-  if ( split2 ) {
-    e2.pos = ( v2.pos + v3.pos ) * 0.5F;
-    e2.col = ( v2.col + v3.col ) * 0.5F;
-    e2.uv  = ( v2.uv + v3.uv ) * 0.5F;
-    e2.nrm = normal;
-    output.pushVertex( e2, tex_map, bilinear );
-  }
-  if ( split3 ) {
-    e3.pos = ( v3.pos + v1.pos ) * 0.5F;
-    e3.col = ( v3.col + v1.col ) * 0.5F;
-    e3.uv  = ( v3.uv + v1.uv ) * 0.5F;
-    e3.nrm = normal;
-    output.pushVertex( e3, tex_map, bilinear );
-  }
+void subdivideTriangleEdge( SubdivisionVertices&              vertices,
+                            std::vector<SubdivisionTriangle>& stack,
+                            const float                       lengthThreshold,
+                            ParallelModelBuilder&             output,
+                            const size_t                      block ) {
+  stack.clear();
+  stack.push_back( { 0, 1, 2 } );
+  while ( !stack.empty() ) {
+    const SubdivisionTriangle tri = stack.back();
+    stack.pop_back();
+    const uint32_t  v1 = tri.v1, v2 = tri.v2, v3 = tri.v3;
+    const glm::vec3 p1 = vertices[v1].pos, p2 = vertices[v2].pos, p3 = vertices[v3].pos;
+
+    // the face normal
+    glm::vec3 normal;
+    Geometry::triangleNormal( p1, p2, p3, normal );
 
-  // go deeper in the subdivision if needed
-  // three edge split
-  if ( split1 && split2 && split3 ) {
-    subdivideTriangleEdge( e1, e2, e3, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( v1, e1, e3, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( e1, v2, e2, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( e2, v3, e3, tex_map, lengthThreshold, bilinear, output );
-    return;
-  }
-  // two edge split
-  if ( !split1 && split2 && split3 ) {
-    subdivideTriangleEdge( v1, v2, e3, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( e3, v2, e2, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( e2, v3, e3, tex_map, lengthThreshold, bilinear, output );
-    return;
-  }
-  if ( split1 && !split2 && split3 ) {
-    subdivideTriangleEdge( v1, e1, e3, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( e1, v2, e3, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( v2, v3, e3, tex_map, lengthThreshold, bilinear, output );
-    return;
-  }
-  if ( split1 && split2 && !split3 ) {
-    subdivideTriangleEdge( v1, e1, v3, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( e1, e2, v3, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( e1, v2, e2, tex_map, lengthThreshold, bilinear, output );
-    return;
-  }
-  // one edge split
-  if ( !split1 && !split2 && split3 ) {
-    subdivideTriangleEdge( v1, v2, e3, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( v2, v3, e3, tex_map, lengthThreshold, bilinear, output );
-    return;
-  }
-  if ( !split1 && split2 && !split3 ) {
-    subdivideTriangleEdge( v1, v2, e2, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( v1, e2, v3, tex_map, lengthThreshold, bilinear, output );
-    return;
-  }
-  if ( split1 && !split2 && !split3 ) {
-    subdivideTriangleEdge( v1, e1, v3, tex_map, lengthThreshold, bilinear, output );
-    subdivideTriangleEdge( e1, v2, v3, tex_map, lengthThreshold, bilinear, output );
-    return;
+    // do we split the edges: length(edge)/2 >= threshold
+    const bool split1 = glm::length( p2 - p1 ) * 0.5F >= lengthThreshold;
+    const bool split2 = glm::length( p2 - p3 ) * 0.5F >= lengthThreshold;
+    const bool split3 = glm::length( p3 - p1 ) * 0.5F >= lengthThreshold;
+
+    // early return if threshold reached for each edge
+    if ( !split1 && !split2 && !split3 ) continue;
+
+    // compute and push the new edge centers if needed,
+    uint32_t e1 = 0, e2 = 0, e3 = 0;
+    if ( split1 ) {
+      e1 = vertices.midpoint( v1, v2, true );
+      vertices.push( output, block, e1, normal );
+    }
+    if ( split2 ) {
+      e2 = vertices.midpoint( v2, v3, true );
+      vertices.push( output, block, e2, normal );
+    }
+    if ( split3 ) {
+      e3 = vertices.midpoint( v3, v1, true );
+      vertices.push( output, block, e3, normal );
+    }
+
+    // go deeper in the subdivision if needed
+    SubdivisionTriangle children[4];
+    size_t              childCount = 0;
+    // three edge split
+    if ( split1 && split2 && split3 ) {
+      children[childCount++] = { e1, e2, e3 };
+      children[childCount++] = { v1, e1, e3 };
+      children[childCount++] = { e1, v2, e2 };
+      children[childCount++] = { e2, v3, e3 };
+    }
+    // two edge split
+    else if ( !split1 && split2 && split3 ) {
+      children[childCount++] = { v1, v2, e3 };
+      children[childCount++] = { e3, v2, e2 };
+      children[childCount++] = { e2, v3, e3 };
+    } else if ( split1 && !split2 && split3 ) {
+      children[childCount++] = { v1, e1, e3 };
+      children[childCount++] = { e1, v2, e3 };
+      children[childCount++] = { v2, v3, e3 };
+    } else if ( split1 && split2 && !split3 ) {
+      children[childCount++] = { v1, e1, v3 };
+      children[childCount++] = { e1, e2, v3 };
+      children[childCount++] = { e1, v2, e2 };
+    }
+    // one edge split
+    else if ( !split1 && !split2 && split3 ) {
+      children[childCount++] = { v1, v2, e3 };
+      children[childCount++] = { v2, v3, e3 };
+    } else if ( !split1 && split2 && !split3 ) {
+      children[childCount++] = { v1, v2, e2 };
+      children[childCount++] = { v1, e2, v3 };
+    } else if ( split1 && !split2 && !split3 ) {
+      children[childCount++] = { v1, e1, v3 };
+      children[childCount++] = { e1, v2, v3 };
+    }
+    // last sub triangle on the stack is processed first
+    while ( childCount != 0 ) stack.push_back( children[--childCount] );
   }
 }
 
 // Use triangle subdivision algorithm to perform the sampling
 // Use subdiv scheme without T-vertices, stop criterion on edge size
-void Sample::meshToPcDivEdge( const Model& input,
-                              Model&       output,
-                              const Image& tex_map,
-                              float        lengthThreshold,
-                              size_t       resolution,
-                              bool         bilinear,
-                              bool         logProgress,
-                              float&       computedThres ) {
+size_t Sample::meshToPcDivEdge( const Model& input,
+                                Model&       output,
+                                const Image& tex_map,
+                                float        lengthThreshold,
+                                size_t       resolution,
+                                bool         bilinear,
+                                bool         logProgress,
+                                float&       computedThres,
+                                bool         countOnly ) {
   float length = lengthThreshold;
 
   if ( length == 0 ) {
     std::cout << "Overriding lengthThreshold from resolution=" << resolution << std::endl;
     if ( resolution == 0 ) {
       std::cout << "Error: resolution must be > 0 if lengthThreshold = 0.0" << std::endl;
-      return;
+      return 0;
     }
     // computes the bounding box of the vertices
     glm::vec3 minPos, maxPos;
@@ -821,45 +1241,70 @@ void Sample::meshToPcDivEdge( const Model& input,
     computedThres = length;  // forwards to caller, only if internally computed
   }
 
-  // to prevent storing duplicate points, we use a ModelBuilder
-  ModelBuilder builder( output );
+  // to prevent storing duplicate points, we use a ModelBuilder per block of triangles.
+  // blocks are subdivided concurrently and merged in triangle order.
+  const size_t         triangleCount = input.triangles.size() / 3;
+  const size_t         blockSize     = 256;
+  const int64_t        blockCount    = ( triangleCount + blockSize - 1 ) / blockSize;
+  ParallelModelBuilder builder( blockCount );
 
   // number of degenerate triangles
   size_t skipped = 0;
 
   // For each triangle
-  for ( size_t triIdx = 0; triIdx < input.triangles.size() / 3; ++triIdx ) {
-    if ( logProgress ) std::cout << '\r' << triIdx << "/" << input.triangles.size() / 3 << std::flush;
+#pragma omp parallel for reduction( + : skipped ) schedule( dynamic )
+  for ( int64_t block = 0; block < blockCount; ++block ) {
+    // planning pass, the block is sized for the estimated point count of its triangles
+    auto estimate = [&]( const Vertex& v1, const Vertex& v2, const Vertex& v3 ) {
+      return estimateDivEdgeCount( v1, v2, v3, length );
+    };
+    const size_t blockEnd = std::min( triangleCount, ( block + 1 ) * blockSize );
+    builder.reserve( block, estimatePointCount( input, block * blockSize, blockEnd, estimate ) );
+    SubdivisionVertices              vertices( tex_map, bilinear, countOnly );
+    std::vector<SubdivisionTriangle> stack;
+    std::vector<glm::vec3>           normals;
+    computeBlockNormals( input, block * blockSize, blockEnd, normals );
+    for ( size_t triIdx = block * blockSize; triIdx < blockEnd; ++triIdx ) {
+      if ( logProgress ) {
+#pragma omp critical
+        std::cout << '\r' << triIdx << "/" << triangleCount << std::flush;
+      }
 
-    Vertex v1, v2, v3;
+      Vertex v1, v2, v3;
 
-    fetchTriangle(
-      input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
+      fetchTriangle(
+        input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
 
-    // check if triangle is not degenerate
-    if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
-      ++skipped;
-      continue;
-    }
+      // check if triangle is not degenerate
+      if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
+        ++skipped;
+        continue;
+      }
 
-    // compute face normal (forces) - might be better as an option
-    glm::vec3 normal;
-    Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
-    v1.nrm = v2.nrm = v3.nrm = normal;
-    v1.hasNormal = v2.hasNormal = v3.hasNormal = true;
+      // face normal (forces) - might be better as an option
+      const glm::vec3& normal = normals[triIdx - block * blockSize];
 
-    // push the vertices if needed
-    builder.pushVertex( v1, tex_map, bilinear );
-    builder.pushVertex( v2, tex_map, bilinear );
-    builder.pushVertex( v3, tex_map, bilinear );
+      // push the vertices if needed
+      vertices.reset( v1, v2, v3 );
+      vertices.push( builder, block, 0, normal );
+      vertices.push( builder, block, 1, normal );
+      vertices.push( builder, block, 2, normal );
 
-    // subdivide recursively
-    subdivideTriangleEdge( v1, v2, v3, tex_map, length, bilinear, builder );
+      // subdivide
+      subdivideTriangleEdge( vertices, stack, length, builder, block );
+    }
+  }
+  size_t count = 0;
+  if ( countOnly ) count = builder.count();
+  else {
+    builder.merge( output );
+    count = output.vertices.size() / 3;
   }
   if ( logProgress ) std::cout << std::endl;
   if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
   if ( builder.foundCount != 0 ) std::cout << "Handled " << builder.foundCount << " duplicate vertices" << std::endl;
-  std::cout << "Generated " << output.vertices.size() / 3 << " points" << std::endl;
+  std::cout << ( countOnly ? "Counted " : "Generated " ) << count << " points" << std::endl;
+  return count;
 }
 
 void Sample::meshToPcDivEdge( const Model& input,
@@ -871,40 +1316,27 @@ void Sample::meshToPcDivEdge( const Model& input,
                               bool         bilinear,
                               bool         logProgress,
                               float&       computedThres ) {
-  float value = 1.0;
+  // the density is the inverse of the length threshold
+  auto estimate = [&]( double density ) {
+    const float lengthThreshold = (float)( 1.0 / density );
+    return estimateModelPointCount( input, [&]( const Vertex& v1, const Vertex& v2, const Vertex& v3 ) {
+      return estimateDivEdgeCount( v1, v2, v3, lengthThreshold );
+    } );
+  };
   float unused;
-  meshToPcDivEdge( input, output, tex_map, value, 0, bilinear, logProgress, unused );
-  // search to init the algo bounds
-  float minBound = 0;
-  float maxBound = 0;
-  //
-  size_t iter = 0;
-  while ( ( output.getPositionCount() < nbSamplesMin || output.getPositionCount() > nbSamplesMax )
-          && iter < maxIterations ) {
-    iter++;
-    // let's refine
-    if ( output.getPositionCount() > nbSamplesMin ) {  // need to remove some points
-      minBound = value;
-      if ( maxBound == 0 ) {
-        value = minBound * 2;
-      } else {
-        value = minBound + ( maxBound - minBound ) / 2;
-      }
-    }
-    if ( output.getPositionCount() < nbSamplesMax ) {  // need to add some points
-      maxBound = value;
-      value    = minBound + ( maxBound - minBound ) / 2;
-    }
-    std::cout << "  posCount=" << output.getPositionCount() << std::endl;
-    std::cout << "  minBound=" << minBound << std::endl;
-    std::cout << "  maxBound=" << maxBound << std::endl;
-    std::cout << "  value=" << value << std::endl;
-    //
-    output.reset();
-    meshToPcDivEdge( input, output, tex_map, value, 0, bilinear, logProgress, unused );
-  }
-  computedThres = value;
+  auto  count = [&]( double density ) {
+    std::cout << "  value=" << (float)( 1.0 / density ) << std::endl;
+    return meshToPcDivEdge(
+      input, output, tex_map, (float)( 1.0 / density ), 0, bilinear, logProgress, unused, true );
+  };
+  size_t       iter    = 0;
+  const double density =
+    searchDensity( 1.0, 0.0, false, nbSamplesMin, nbSamplesMax, maxIterations, estimate, count, iter );
+  computedThres = (float)( 1.0 / density );
   std::cout << "algorithm ended after " << iter << " iterations " << std::endl;
+  // the model is only generated at the threshold found
+  output.reset();
+  meshToPcDivEdge( input, output, tex_map, computedThres, 0, bilinear, logProgress, unused );
 }
 
 // Use uniform sampling algorithm
@@ -921,103 +1353,130 @@ void Sample::meshToPcPrnd( const Model& input,
   // number of degenerate triangles
   size_t skipped = 0;
 
-  // to prevent storing duplicate points, we use a ModelBuilder
-  ModelBuilder builder( output );
-  double       totalArea = 0.0f;
-  for ( size_t triIdx = 0; triIdx < input.triangles.size() / 3; ++triIdx ) {
-    Vertex v1, v2, v3;
-
-    fetchTriangle(
-      input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
-    totalArea += Geometry::triangleArea( v1.pos, v2.pos, v3.pos );
+  // the areas are computed concurrently, then summed in triangle order
+  const size_t        triangleCount = input.triangles.size() / 3;
+  std::vector<double> areas( triangleCount );
+#pragma omp parallel for
+  for ( int64_t triIdx = 0; triIdx < (int64_t)triangleCount; ++triIdx ) {
+    glm::vec3 v1, v2, v3;
+    input.fetchTriangleVertices( triIdx, v1, v2, v3 );
+    areas[triIdx] = Geometry::triangleArea( v1, v2, v3 );
+  }
+  double totalArea = 0.0;
+  for ( const double area : areas ) totalArea += area;
+
+  // planning pass, the number of points of each triangle is given by its area.
+  // the prefix sums of the pushed vertices give the size of each block
+  std::vector<size_t> pushStarts( triangleCount + 1, 0 );
+  for ( size_t triIdx = 0; triIdx < triangleCount; ++triIdx ) {
+    const double area      = areas[triIdx];
+    pushStarts[triIdx + 1] = pushStarts[triIdx];
+    if ( area >= DBL_EPSILON )
+      pushStarts[triIdx + 1] += 2 + (size_t)std::max( 1.0, std::ceil( targetPointCount * area / totalArea ) );
   }
 
+  // to prevent storing duplicate points, we use a ModelBuilder per block of triangles.
+  // each triangle has its own sequence, blocks are sampled concurrently and merged in triangle order.
+  const size_t         blockSize  = 256;
+  const int64_t        blockCount = ( triangleCount + blockSize - 1 ) / blockSize;
+  ParallelModelBuilder builder( blockCount );
+
   const auto g  = 1.0f / 1.32471795572f;
   const auto g2 = g * g;
 
   // For each triangle
-  for ( size_t triIdx = 0; triIdx < input.triangles.size() / 3; ++triIdx ) {
-    if ( logProgress ) std::cout << '\r' << triIdx << "/" << input.triangles.size() / 3 << std::flush;
-
-    Vertex v1, v2, v3;
-    fetchTriangle(
-      input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
-
-    // check if triangle is not degenerate
-    if ( Geometry::triangleArea( v1.pos, v2.pos, v3.pos ) < DBL_EPSILON ) {
-      ++skipped;
-      continue;
-    }
+#pragma omp parallel for reduction( + : skipped ) schedule( dynamic )
+  for ( int64_t block = 0; block < blockCount; ++block ) {
+    const size_t blockEnd = std::min( triangleCount, ( block + 1 ) * blockSize );
+    builder.reserve( block, pushStarts[blockEnd] - pushStarts[block * blockSize] );
+    std::vector<glm::vec3> normals;
+    computeBlockNormals( input, block * blockSize, blockEnd, normals );
+    for ( size_t triIdx = block * blockSize; triIdx < blockEnd; ++triIdx ) {
+      if ( logProgress ) {
+#pragma omp critical
+        std::cout << '\r' << triIdx << "/" << triangleCount << std::flush;
+      }
 
-    const auto triArea    = Geometry::triangleArea( v1.pos, v2.pos, v3.pos );
-    const auto pointCount = std::ceil( targetPointCount * triArea / totalArea );
+      Vertex v1, v2, v3;
+      fetchTriangle(
+        input, triIdx, input.uvcoords.size() != 0, input.colors.size() != 0, input.normals.size() != 0, v1, v2, v3 );
 
-    // compute face normal (forces) - might be better as an option
-    glm::vec3 normal;
-    Geometry::triangleNormal( v1.pos, v2.pos, v3.pos, normal );
-    v1.nrm = v2.nrm = v3.nrm = normal;
-    v1.hasNormal = v2.hasNormal = v3.hasNormal = true;
-
-    // push the vertices
-    builder.pushVertex( v1, tex_map, bilinear );
-    builder.pushVertex( v2, tex_map, bilinear );
-    builder.pushVertex( v3, tex_map, bilinear );
-
-    const auto d12 = glm::distance( v1.pos, v2.pos );
-    const auto d23 = glm::distance( v2.pos, v3.pos );
-    const auto d31 = glm::distance( v3.pos, v1.pos );
-
-    glm::vec3 dpos0, dpos1, pos;
-    glm::vec2 duv0, duv1, uv;
-    if ( d12 >= d23 && d12 >= d31 ) {
-      uv   = v3.uv;
-      duv0 = v1.uv - v3.uv;
-      duv1 = v2.uv - v3.uv;
-
-      pos   = v3.pos;
-      dpos0 = v1.pos - v3.pos;
-      dpos1 = v2.pos - v3.pos;
-    } else if ( d31 >= d23 ) {
-      uv   = v2.uv;
-      duv0 = v1.uv - v2.uv;
-      duv1 = v3.uv - v2.uv;
-
-      pos   = v2.pos;
-      dpos0 = v1.pos - v2.pos;
-      dpos1 = v3.pos - v2.pos;
-    } else {
-      uv   = v1.uv;
-      duv0 = v2.uv - v1.uv;
-      duv1 = v3.uv - v1.uv;
+      // check if triangle is not degenerate
+      if ( areas[triIdx] < DBL_EPSILON ) {
+        ++skipped;
+        continue;
+      }
 
-      pos   = v1.pos;
-      dpos0 = v2.pos - v1.pos;
-      dpos1 = v3.pos - v1.pos;
-    }
+      const auto triArea    = areas[triIdx];
+      const auto pointCount = std::ceil( targetPointCount * triArea / totalArea );
+
+      // face normal (forces) - might be better as an option
+      const glm::vec3& normal = normals[triIdx - block * blockSize];
+      v1.nrm = v2.nrm = v3.nrm = normal;
+      v1.hasNormal = v2.hasNormal = v3.hasNormal = true;
+
+      // push the vertices
+      builder.pushVertex( block, v1, tex_map, bilinear );
+      builder.pushVertex( block, v2, tex_map, bilinear );
+      builder.pushVertex( block, v3, tex_map, bilinear );
+
+      const auto d12 = glm::distance( v1.pos, v2.pos );
+      const auto d23 = glm::distance( v2.pos, v3.pos );
+      const auto d31 = glm::distance( v3.pos, v1.pos );
+
+      glm::vec3 dpos0, dpos1, pos;
+      glm::vec2 duv0, duv1, uv;
+      if ( d12 >= d23 && d12 >= d31 ) {
+        uv   = v3.uv;
+        duv0 = v1.uv - v3.uv;
+        duv1 = v2.uv - v3.uv;
+
+        pos   = v3.pos;
+        dpos0 = v1.pos - v3.pos;
+        dpos1 = v2.pos - v3.pos;
+      } else if ( d31 >= d23 ) {
+        uv   = v2.uv;
+        duv0 = v1.uv - v2.uv;
+        duv1 = v3.uv - v2.uv;
+
+        pos   = v2.pos;
+        dpos0 = v1.pos - v2.pos;
+        dpos1 = v3.pos - v2.pos;
+      } else {
+        uv   = v1.uv;
+        duv0 = v2.uv - v1.uv;
+        duv1 = v3.uv - v1.uv;
 
-    // the new vertices
-    Vertex vertex;
-    // we use v1 as reference in term of components to push
-    vertex.hasColor   = v1.hasColor;
-    vertex.hasUVCoord = v1.hasUVCoord;
-    // forces normals, we use generated per face ones
-    vertex.hasNormal = true;
+        pos   = v1.pos;
+        dpos0 = v2.pos - v1.pos;
+        dpos1 = v3.pos - v1.pos;
+      }
 
-    for ( int i = 1; i < pointCount; ++i ) {
-      const auto r1 = i * g;
-      const auto r2 = i * g2;
-      auto       x  = r1 - std::floor( r1 );
-      auto       y  = r2 - std::floor( r2 );
-      if ( x + y > 1.0f ) {
-        x = 1.0f - x;
-        y = 1.0f - y;
+      // the new vertices
+      Vertex vertex;
+      // we use v1 as reference in term of components to push
+      vertex.hasColor   = v1.hasColor;
+      vertex.hasUVCoord = v1.hasUVCoord;
+      // forces normals, we use generated per face ones
+      vertex.hasNormal = true;
+
+      for ( int i = 1; i < pointCount; ++i ) {
+        const auto r1 = i * g;
+        const auto r2 = i * g2;
+        auto       x  = r1 - std::floor( r1 );
+        auto       y  = r2 - std::floor( r2 );
+        if ( x + y > 1.0f ) {
+          x = 1.0f - x;
+          y = 1.0f - y;
+        }
+        vertex.pos = pos + x * dpos0 + y * dpos1;
+        vertex.uv  = uv + x * duv0 + y * duv1;
+        vertex.nrm = normal;
+        builder.pushVertex( block, vertex, tex_map, bilinear );
       }
-      vertex.pos = pos + x * dpos0 + y * dpos1;
-      vertex.uv  = uv + x * duv0 + y * duv1;
-      vertex.nrm = normal;
-      builder.pushVertex( vertex, tex_map, bilinear );
     }
   }
+  builder.merge( output );
   if ( logProgress ) std::cout << std::endl;
   if ( skipped != 0 ) std::cout << "Skipped " << skipped << " degenerate triangles" << std::endl;
   if ( builder.foundCount != 0 ) std::cout << "Handled " << builder.foundCount << " duplicate vertices" << std::endl;
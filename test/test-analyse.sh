@@ -20,3 +20,18 @@ $CMD sequence --firstFrame 1 --lastFrame 3 END \
 	--inputMap ${DATA}/basketball_player_0000000%1d.png END \
 	> ${TMP}/${OUT}.txt 2>&1
 grep -iF "error" ${TMP}/${OUT}.txt
+
+# test sequence mode with frames processed in parallel, outputs shall match sequential processing
+OUT=analyse_basketball_player_3frames_parallel
+echo $OUT
+$CMD sequence --firstFrame 1 --lastFrame 3 --frameParallel 3 END \
+	analyse --outputCsv ${TMP}/${OUT}.csv --outputVar ${TMP}/${OUT}_var.txt \
+	--inputModel ${DATA}/basketball_player_0000000%1d.obj \
+	--inputMap ${DATA}/basketball_player_0000000%1d.png END \
+	> ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+# the log of each frame shall be printed at once, not interleaved with the other frames
+awk '/^Processing frame/ { frame = $3 } /^Input model:/ && $3 !~ frame ".obj$" { print "Error: log of frame " frame " interleaved" }' \
+	${TMP}/${OUT}.txt
+cmp ${TMP}/${OUT}.csv ${TMP}/analyse_basketball_player_3frames.csv
+cmp ${TMP}/${OUT}_var.txt ${TMP}/analyse_basketball_player_3frames_var.txt
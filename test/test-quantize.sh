@@ -56,6 +56,31 @@ do
 		--minPos="${minPos}" --maxPos="${maxPos}" --minUv="${minUv}" --maxUv="${maxUv}" \
 		> ${TMP}/${OUT2}.txt 2>&1
 	cmp ${TMP}/${OUT2}.obj ${REFS}/${OUT2}.obj
+
+	# 4 - all set through the mmb binary format, reloaded result shall match the obj output
+	OUT=quantize_plane_qp${q}_qt${q}_qn${q}_qc${q}_mmb
+	echo $OUT
+	$CMD quantize -i ${DATA}/plane.obj -o ${TMP}/${OUT}.mmb --qp ${q} --qt ${q} --qn ${q} --qc ${q} > ${TMP}/${OUT}.txt 2>&1
+	$CMD quantize -i ${TMP}/${OUT}.mmb -o ${TMP}/${OUT}.obj --qp 0 --qt 0 --qn 0 --qc 0 >> ${TMP}/${OUT}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}.txt
+	cmp ${TMP}/${OUT}.obj ${REFS}/quantize_plane_qp${q}_qt${q}_qn${q}_qc${q}.obj
+
+	# 5 - all set with the on-disk model cache, second run loads from cache
+	OUT=quantize_plane_qp${q}_qt${q}_qn${q}_qc${q}_cache
+	echo $OUT
+	rm -rf ${TMP}/${OUT}_dir
+	for run in 1 2
+	do
+		MM_CACHE_DIR=${TMP}/${OUT}_dir $CMD quantize -i ${DATA}/plane.obj -o ${TMP}/${OUT}.obj --qp ${q} --qt ${q} --qn ${q} --qc ${q} > ${TMP}/${OUT}.txt 2>&1
+		cmp ${TMP}/${OUT}.obj ${REFS}/quantize_plane_qp${q}_qt${q}_qn${q}_qc${q}.obj
+	done
+	grep -qF "(from cache)" ${TMP}/${OUT}.txt || echo "Error: ${OUT} not loaded from cache"
+
+	# a snapshot written by another loader version is discarded and the source file parsed again
+	for f in ${TMP}/${OUT}_dir/*.mmb; do printf '\377' | dd of=$f bs=1 seek=16 conv=notrunc status=none; done
+	MM_CACHE_DIR=${TMP}/${OUT}_dir $CMD quantize -i ${DATA}/plane.obj -o ${TMP}/${OUT}.obj --qp ${q} --qt ${q} --qn ${q} --qc ${q} > ${TMP}/${OUT}.txt 2>&1
+	cmp ${TMP}/${OUT}.obj ${REFS}/quantize_plane_qp${q}_qt${q}_qn${q}_qc${q}.obj
+	grep -qF "(from cache)" ${TMP}/${OUT}.txt && echo "Error: ${OUT} loaded from a snapshot of another loader version"
 done
 
 fi
@@ -23,6 +23,19 @@ if [ "$1" == "" ] || [ "$1" == "ext" ] ||  [ "$1" == "$OUT" ]; then
 	cmp ${TMP}/sample_face_plane_10_nearest_10_10.ply ${REFS}/sample_face_plane_10_nearest_10_10.ply
 fi
 
+# binary ply output, converted back to ascii shall match the ascii reference
+OUT=sample_face_plane_binary
+if [ "$1" == "" ] || [ "$1" == "ext" ] ||  [ "$1" == "$OUT" ]; then
+	echo $OUT
+	$CMD \
+		sample -i ${DATA}/plane.obj -m ${DATA}/plane.png -o ${TMP}/${OUT}.ply \
+			--mode face --hideProgress --resolution 10 --bilinear --plyFormat binary END \
+		quantize -i ${TMP}/${OUT}.ply -o ${TMP}/${OUT}_ascii.ply --qp 0 --qt 0 --qn 0 --qc 0 \
+	> ${TMP}/${OUT}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}.txt
+	cmp ${TMP}/${OUT}_ascii.ply ${REFS}/sample_face_plane_10_bilinear_2_2.ply
+fi
+
 # test irregular mesh
 # generated files are refered to by the meshlab project located in meshlab subfolder
 OUT=sample_face_plane_irregular_10_10_10
@@ -95,6 +108,8 @@ if [ "$1" == "ext" ] ||  [ "$1" == "$OUT" ]; then
 		${DUMP} --mode face --hideProgress --nbSamplesMin 1000000 --nbSamplesMax 1001000 --maxIterations 5 \
 		--outputCsv ${STATS} > ${TMP}/${OUT}.txt 2>&1
 	grep -iF "error" ${TMP}/${OUT}.txt
+	# resolutions 930 and 931 give 999854 and 1001903 points, the closest is kept
+	fileHasString ${TMP}/${OUT}.txt "the closest gives 999854 points" 1
 fi
 
 OUT=sample_face_basketball_player_00000001_auto_2M
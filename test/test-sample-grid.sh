@@ -62,6 +62,13 @@ $CMD sample -i ${DATA}/degenerate.obj -o ${TMP}/${OUT}.ply --mode grid --hidePro
 grep -iF "error" ${TMP}/${OUT}.txt
 fileHasString ${TMP}/${OUT}.txt "Skipped 1 degenerate triangles" 1
 
+# count only, same count as sample_grid_sphere_10
+OUT=sample_grid_sphere_10_count
+echo $OUT
+$CMD sample -i ${DATA}/sphere.obj -m ${DATA}/plane.png -o ${TMP}/${OUT}.ply --mode grid --hideProgress --gridSize 10 --countOnly > ${TMP}/${OUT}.txt 2>&1
+grep -iF "error" ${TMP}/${OUT}.txt
+fileHasString ${TMP}/${OUT}.txt "Counted 370 points" 1
+
 # extended tests
 if [ "$1" == "ext" ]; 
 then
@@ -100,6 +107,17 @@ then
 		${DUMP} --mode grid --hideProgress --gridSize 1024  --outputCsv ${STATS} > ${TMP}/${OUT}.txt 2>&1
 	grep -iF "error" ${TMP}/${OUT}.txt
 	
+	# count only on a textured model, the points of the texture seams are counted as sampled
+	OUT=sample_grid_basketball_player_00000001_bilinear_2048_count
+	echo $OUT
+	$CMD sample -i ${DATA}/basketball_player_00000001.obj -m ${DATA}/basketball_player_00000001.png \
+		-o ID:NUL --mode grid --hideProgress --gridSize 2048 --bilinear > ${TMP}/${OUT}.txt 2>&1
+	$CMD sample -i ${DATA}/basketball_player_00000001.obj -m ${DATA}/basketball_player_00000001.png \
+		-o ID:NUL --mode grid --hideProgress --gridSize 2048 --bilinear --countOnly >> ${TMP}/${OUT}.txt 2>&1
+	grep -iF "error" ${TMP}/${OUT}.txt
+	fileHasString ${TMP}/${OUT}.txt "Generated 3973173 points" 1
+	fileHasString ${TMP}/${OUT}.txt "Counted 3973173 points" 1
+	
 	# compare the overall results
 	echo "Compare overall result csv"
 	diff -a ${TMP}/sample_grid.csv ${REFS}/sample_grid.csv